@@ -0,0 +1,23 @@
+// Entry point shared by the benchmark executables. Results go to stdout as JSON unless another
+// --benchmark_format is given; --benchmark_out=<file> writes a JSON copy as well.
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    // JSON on stdout unless another format is asked for, so runs can be diffed for regressions
+    std::vector<char*> args(argv, argv + argc);
+    std::string json_format = "--benchmark_format=json";
+    bool has_format = std::any_of(args.begin() + 1, args.end(), [](const char* arg) {
+        return std::strncmp(arg, "--benchmark_format", 18) == 0;
+    });
+    if (!has_format) args.push_back(&json_format[0]);
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
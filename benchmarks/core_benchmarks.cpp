@@ -0,0 +1,355 @@
+// Benchmarks for the hot paths of the planning core; they link only the core library, so they
+// build and run without ROS. The plugin's path post-processing is in plugin_benchmarks.cpp.
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "nav2_rrtstar_planner/planner_core.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+namespace
+{
+
+constexpr unsigned int kMapCells = 1000;
+constexpr double kResolution = 0.05;
+constexpr double kStartX = 2.5, kStartY = 2.5, kGoalX = 47.5, kGoalY = 47.5;
+
+enum MapKind { kOpenField, kMaze, kNarrowCorridor, kClutteredWarehouse };
+const char* const kMapNames[] = {"open_field", "maze", "narrow_corridor", "cluttered_warehouse"};
+
+// Synthetic 50 x 50 m maps; start and goal sit in opposite corners of each
+class BenchmarkMap : public GridMap {
+public:
+    explicit BenchmarkMap(MapKind kind) : cells_(kMapCells * kMapCells, 0) {
+        switch (kind) {
+            case kOpenField: break;
+            case kMaze: buildMaze(); break;
+            case kNarrowCorridor: buildNarrowCorridor(); break;
+            case kClutteredWarehouse: buildClutteredWarehouse(); break;
+        }
+    }
+
+    GridView view() const override {
+        return GridView{cells_.data(), kMapCells, kMapCells, 0.0, 0.0, kResolution};
+    }
+
+private:
+    // Blocks the cells of the box [x0, x1) x [y0, y1), in meters
+    void block(double x0, double y0, double x1, double y1) {
+        unsigned int cx0 = static_cast<unsigned int>(std::max(x0, 0.0) / kResolution);
+        unsigned int cy0 = static_cast<unsigned int>(std::max(y0, 0.0) / kResolution);
+        unsigned int cx1 = std::min(static_cast<unsigned int>(x1 / kResolution), kMapCells);
+        unsigned int cy1 = std::min(static_cast<unsigned int>(y1 / kResolution), kMapCells);
+        for (unsigned int y = cy0; y < cy1; ++y) {
+            std::memset(&cells_[y * kMapCells + cx0], 254, cx1 > cx0 ? cx1 - cx0 : 0);
+        }
+    }
+
+    // A 10 x 10 perfect maze of 5 m rooms with 0.5 m walls, carved by a seeded depth-first walk
+    void buildMaze() {
+        constexpr int kRooms = 10;
+        constexpr double kRoom = 5.0, kWall = 0.5;
+        std::vector<bool> visited(kRooms * kRooms, false);
+        // open_east[r] / open_north[r]: the wall on that side of room r is carved away
+        std::vector<bool> open_east(kRooms * kRooms, false), open_north(kRooms * kRooms, false);
+        std::mt19937 gen(7);
+        std::vector<int> stack{0};
+        visited[0] = true;
+        while (!stack.empty()) {
+            int room = stack.back();
+            int rx = room % kRooms, ry = room / kRooms;
+            int options[4], count = 0;
+            if (rx + 1 < kRooms && !visited[room + 1]) options[count++] = room + 1;
+            if (rx > 0 && !visited[room - 1]) options[count++] = room - 1;
+            if (ry + 1 < kRooms && !visited[room + kRooms]) options[count++] = room + kRooms;
+            if (ry > 0 && !visited[room - kRooms]) options[count++] = room - kRooms;
+            if (count == 0) {
+                stack.pop_back();
+                continue;
+            }
+            int next = options[std::uniform_int_distribution<int>(0, count - 1)(gen)];
+            if (next == room + 1) open_east[room] = true;
+            if (next == room - 1) open_east[next] = true;
+            if (next == room + kRooms) open_north[room] = true;
+            if (next == room - kRooms) open_north[next] = true;
+            visited[next] = true;
+            stack.push_back(next);
+        }
+        for (int ry = 0; ry < kRooms; ++ry) {
+            for (int rx = 0; rx < kRooms; ++rx) {
+                int room = ry * kRooms + rx;
+                double x = rx * kRoom, y = ry * kRoom;
+                if (rx + 1 < kRooms && !open_east[room]) block(x + kRoom - kWall / 2, y, x + kRoom + kWall / 2, y + kRoom);
+                if (ry + 1 < kRooms && !open_north[room]) block(x, y + kRoom - kWall / 2, x + kRoom, y + kRoom + kWall / 2);
+            }
+        }
+        // Pillars where walls meet, standing whether or not the walls around them were carved away
+        for (int ry = 1; ry < kRooms; ++ry) {
+            for (int rx = 1; rx < kRooms; ++rx) {
+                block(rx * kRoom - kWall / 2, ry * kRoom - kWall / 2, rx * kRoom + kWall / 2, ry * kRoom + kWall / 2);
+            }
+        }
+    }
+
+    // A solid band across the middle of the map, pierced by one 1 m wide, 30 m long corridor
+    void buildNarrowCorridor() {
+        block(10.0, 0.0, 40.0, 24.5);
+        block(10.0, 25.5, 40.0, 50.0);
+    }
+
+    // Rows of 1 m deep racks with 2 m aisles and a cross aisle, strewn with pallets
+    void buildClutteredWarehouse() {
+        for (double x = 6.0; x < 45.0; x += 3.0) {
+            block(x, 5.0, x + 1.0, 23.0);
+            block(x, 27.0, x + 1.0, 45.0);
+        }
+        std::mt19937 gen(11);
+        std::uniform_real_distribution<double> position(5.0, 45.0);
+        for (int i = 0; i < 150; ++i) {
+            double x = position(gen), y = position(gen);
+            block(x, y, x + 0.6, y + 0.6);
+        }
+    }
+
+    std::vector<unsigned char> cells_;
+};
+
+// Exposes the core's internals to the micro benchmarks
+class BenchmarkCore : public PlannerCore {
+public:
+    using PlannerCore::nearest_neighbor;
+    using PlannerCore::findVerticesInsideCircle;
+    using PlannerCore::connectible;
+    using PlannerCore::calculate_cost_from_start;
+    using PlannerCore::calculateBallRadius;
+    using PlannerCore::tree_;
+    using PlannerCore::vertices_inside_circle_;
+    using PlannerCore::max_connection_distance_;
+};
+
+// Plans are seeded so every iteration, run and thread count grows the same tree
+PlannerConfig benchmarkConfig(int max_iterations) {
+    PlannerConfig config;
+    config.max_iterations = max_iterations;
+    config.deterministic = true;
+    config.seed = 42;
+    return config;
+}
+
+// Grows a tree on the map for the micro benchmarks to query; whether it reached the goal does not matter
+void growTree(BenchmarkCore& core, BenchmarkMap& map, const PlannerConfig& config) {
+    core.configure(config);
+    std::vector<std::pair<double, double>> route;
+    try {
+        core.plan(map, kStartX, kStartY, kGoalX, kGoalY, route);
+    } catch (const PlanningError&) {
+    }
+}
+
+std::vector<std::pair<double, double>> randomPoints(std::size_t count) {
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coordinate(0.0, kMapCells * kResolution);
+    std::vector<std::pair<double, double>> points(count);
+    for (auto& point : points) {
+        point = {coordinate(gen), coordinate(gen)};
+    }
+    return points;
+}
+
+// Sums the edge costs up the parent chain, as the cost-to-come was computed before it was cached
+double costFromStartByChainWalk(const Tree& tree, uint32_t vertex) {
+    double cost = 0.0;
+    for (; tree.parent[vertex] != Tree::kNone; vertex = tree.parent[vertex]) {
+        cost += tree.cost[vertex];
+    }
+    return cost;
+}
+
+}  // namespace
+
+// Full planning pipeline of createPlan, minus the path message: map sync, tree growth, goal
+// connection and route extraction. Args: map kind, max_iterations.
+static void BM_Plan(benchmark::State& state) {
+    BenchmarkMap map(static_cast<MapKind>(state.range(0)));
+    PlannerCore core;
+    core.configure(benchmarkConfig(static_cast<int>(state.range(1))));
+    std::vector<std::pair<double, double>> route;
+    double cost = 0.0, vertices = 0.0, failures = 0.0;
+    for (auto _ : state) {
+        try {
+            core.plan(map, kStartX, kStartY, kGoalX, kGoalY, route);
+            cost += core.statistics().solution_cost;
+        } catch (const PlanningError&) {
+            failures += 1.0;
+        }
+        vertices += core.statistics().vertices;
+    }
+    state.SetLabel(kMapNames[state.range(0)]);
+    // Mean cost over the plans that succeeded
+    state.counters["solution_cost"] = cost / std::max(static_cast<double>(state.iterations()) - failures, 1.0);
+    state.counters["vertices"] = benchmark::Counter(vertices, benchmark::Counter::kAvgIterations);
+    state.counters["failures"] = failures;
+}
+BENCHMARK(BM_Plan)
+    ->ArgsProduct({{kOpenField, kMaze, kNarrowCorridor, kClutteredWarehouse},
+                   {1000, 5000, 10000, 20000, 50000, 100000}})
+    ->Unit(benchmark::kMillisecond);
+
+// Solution cost against max_iterations, over fixed seeds so every point of the series is
+// the same set of trees. Each benchmark iteration plans once per seed. Args: map kind,
+// max_iterations, informed_sampling (0 keeps sampling the whole map, for comparison).
+static void BM_Convergence(benchmark::State& state) {
+    static const uint32_t kSeeds[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    BenchmarkMap map(static_cast<MapKind>(state.range(0)));
+    std::vector<PlannerCore> cores(sizeof(kSeeds) / sizeof(kSeeds[0]));
+    for (std::size_t i = 0; i < cores.size(); ++i) {
+        PlannerConfig config = benchmarkConfig(static_cast<int>(state.range(1)));
+        config.seed = kSeeds[i];
+        config.informed_sampling = state.range(2) != 0;
+        cores[i].configure(config);
+    }
+    std::vector<std::pair<double, double>> route;
+    double cost = 0.0, best = std::numeric_limits<double>::infinity(), worst = 0.0, failures = 0.0;
+    for (auto _ : state) {
+        for (PlannerCore& core : cores) {
+            try {
+                core.plan(map, kStartX, kStartY, kGoalX, kGoalY, route);
+            } catch (const PlanningError&) {
+                failures += 1.0;
+                continue;
+            }
+            cost += core.statistics().solution_cost;
+            best = std::min(best, core.statistics().solution_cost);
+            worst = std::max(worst, core.statistics().solution_cost);
+        }
+    }
+    state.SetLabel(std::string(kMapNames[state.range(0)]) + (state.range(2) ? " informed" : " uniform"));
+    const double plans = static_cast<double>(state.iterations() * cores.size());
+    // Mean, best and worst cost over the plans that succeeded; the seeds give the spread
+    state.counters["solution_cost"] = cost / std::max(plans - failures, 1.0);
+    state.counters["best_cost"] = best;
+    state.counters["worst_cost"] = worst;
+    state.counters["failures"] = failures / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_Convergence)
+    ->ArgsProduct({{kMaze, kClutteredWarehouse}, {500, 1000, 2000, 5000, 10000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// Planning with a growing worker pool. Args: num_threads. Deterministic plans always run all
+// their iterations, so the planning rate is reported in iterations per second of wall time.
+static void BM_PlanThreads(benchmark::State& state) {
+    const int iterations = 5000;
+    BenchmarkMap map(kClutteredWarehouse);
+    PlannerCore core;
+    PlannerConfig config = benchmarkConfig(iterations);
+    config.num_threads = static_cast<int>(state.range(0));
+    core.configure(config);
+    std::vector<std::pair<double, double>> route;
+    for (auto _ : state) {
+        try {
+            core.plan(map, kStartX, kStartY, kGoalX, kGoalY, route);
+        } catch (const PlanningError&) {
+        }
+    }
+    state.counters["iterations_per_second"] = benchmark::Counter(iterations, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_PlanThreads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Args: tree size
+static void BM_NearestNeighbor(benchmark::State& state) {
+    BenchmarkMap map(kOpenField);
+    BenchmarkCore core;
+    growTree(core, map, benchmarkConfig(static_cast<int>(state.range(0))));
+    const auto points = randomPoints(1024);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto& point = points[i++ & 1023];
+        benchmark::DoNotOptimize(core.nearest_neighbor(point.first, point.second));
+    }
+}
+BENCHMARK(BM_NearestNeighbor)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Args: tree size; the radius is the rewire radius at that size. The tree is grown with uniform
+// sampling so it covers the whole map as evenly as the random query points do; a rewire query
+// then returns O(log n) neighbors, which bounds how flat its cost can be.
+static void BM_FindVerticesInsideCircle(benchmark::State& state) {
+    BenchmarkMap map(kOpenField);
+    BenchmarkCore core;
+    PlannerConfig config = benchmarkConfig(static_cast<int>(state.range(0)));
+    config.informed_sampling = false;
+    growTree(core, map, config);
+    const double radius = core.calculateBallRadius(static_cast<int>(core.tree_.size()), 2, core.max_connection_distance_);
+    const auto points = randomPoints(1024);
+    std::size_t i = 0;
+    double neighbors = 0.0;
+    for (auto _ : state) {
+        const auto& point = points[i++ & 1023];
+        core.findVerticesInsideCircle(point.first, point.second, radius, core.vertices_inside_circle_);
+        benchmark::DoNotOptimize(core.vertices_inside_circle_.data());
+        neighbors += static_cast<double>(core.vertices_inside_circle_.size());
+    }
+    state.counters["radius"] = radius;
+    state.counters["neighbors"] = benchmark::Counter(neighbors, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FindVerticesInsideCircle)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
+
+// Edges from tree vertices to random points up to the connection distance away. Args: use_distance_field.
+static void BM_Connectible(benchmark::State& state) {
+    BenchmarkMap map(kClutteredWarehouse);
+    BenchmarkCore core;
+    PlannerConfig config = benchmarkConfig(5000);
+    config.use_distance_field = state.range(0) != 0;
+    growTree(core, map, config);
+
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<uint32_t> vertex(0, static_cast<uint32_t>(core.tree_.size() - 1));
+    std::uniform_real_distribution<double> offset(-core.max_connection_distance_, core.max_connection_distance_);
+    std::vector<std::pair<uint32_t, std::pair<double, double>>> edges(1024);
+    for (auto& edge : edges) {
+        uint32_t from = vertex(gen);
+        edge = {from, {core.tree_.x[from] + offset(gen), core.tree_.y[from] + offset(gen)}};
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto& edge = edges[i++ & 1023];
+        benchmark::DoNotOptimize(core.connectible(core.tree_.x[edge.first], core.tree_.y[edge.first],
+                                                  edge.second.first, edge.second.second));
+    }
+}
+BENCHMARK(BM_Connectible)->Arg(0)->Arg(1);
+
+// The cached cost-to-come against walking the parent chain. Args: tree size, chain_walk.
+static void BM_CalculateCostFromStart(benchmark::State& state) {
+    BenchmarkMap map(kOpenField);
+    BenchmarkCore core;
+    growTree(core, map, benchmarkConfig(static_cast<int>(state.range(0))));
+    std::mt19937 gen(9);
+    std::uniform_int_distribution<uint32_t> vertex(0, static_cast<uint32_t>(core.tree_.size() - 1));
+    std::vector<uint32_t> vertices(1024);
+    for (auto& v : vertices) {
+        v = vertex(gen);
+    }
+    const bool chain_walk = state.range(1) != 0;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const uint32_t v = vertices[i++ & 1023];
+        benchmark::DoNotOptimize(chain_walk ? costFromStartByChainWalk(core.tree_, v) : core.calculate_cost_from_start(v));
+    }
+    double depth = 0.0;
+    for (uint32_t v : vertices) {
+        for (; core.tree_.parent[v] != Tree::kNone; v = core.tree_.parent[v]) {
+            depth += 1.0;
+        }
+    }
+    state.counters["depth"] = depth / vertices.size();
+    state.SetLabel(chain_walk ? "chain walk" : "cached");
+}
+BENCHMARK(BM_CalculateCostFromStart)->ArgsProduct({{10000, 50000, 100000}, {0, 1}});
+
+}  // namespace nav2_rrtstar_planner
@@ -0,0 +1,64 @@
+// Benchmarks for the plugin's path post-processing, which needs no node but links the plugin
+// and its ROS dependencies.
+#include <benchmark/benchmark.h>
+#include <utility>
+#include <vector>
+#include "nav2_rrtstar_planner/rrtstar_planner.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+namespace
+{
+
+// Exposes the plugin's path post-processing
+class BenchmarkPlugin : public RRTStar {
+public:
+    using RRTStar::extractPath;
+    using RRTStar::smoothPath;
+};
+
+// A route of the given length zigzagging across the map in 5 m legs
+std::vector<std::pair<double, double>> zigzagRoute(double length) {
+    std::vector<std::pair<double, double>> route{{5.0, 5.0}};
+    for (double covered = 0.0; covered < length; covered += 5.0) {
+        double x = route.back().first + 3.0;
+        double y = route.size() % 2 ? 9.0 : 5.0;
+        route.emplace_back(x, y);
+    }
+    return route;
+}
+
+}  // namespace
+
+// Densifying a route into the path message. Args: route length in meters.
+static void BM_ExtractPath(benchmark::State& state) {
+    BenchmarkPlugin plugin;
+    const auto route = zigzagRoute(static_cast<double>(state.range(0)));
+    geometry_msgs::msg::Quaternion orientation;
+    nav_msgs::msg::Path path;
+    for (auto _ : state) {
+        plugin.extractPath(route, orientation, path);
+        benchmark::DoNotOptimize(path.poses.data());
+    }
+    state.counters["poses"] = static_cast<double>(path.poses.size());
+}
+BENCHMARK(BM_ExtractPath)->Arg(100);
+
+// Bezier smoothing of a densified path. Args: route length in meters.
+static void BM_SmoothPath(benchmark::State& state) {
+    BenchmarkPlugin plugin;
+    const auto route = zigzagRoute(static_cast<double>(state.range(0)));
+    geometry_msgs::msg::Quaternion orientation;
+    nav_msgs::msg::Path dense, path;
+    plugin.extractPath(route, orientation, dense);
+    for (auto _ : state) {
+        path.poses = dense.poses;
+        plugin.smoothPath(path);
+        benchmark::DoNotOptimize(path.poses.data());
+    }
+    state.counters["poses"] = static_cast<double>(dense.poses.size());
+}
+BENCHMARK(BM_SmoothPath)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+}  // namespace nav2_rrtstar_planner
@@ -0,0 +1,43 @@
+#ifndef NAV2_RRTSTAR_PLANNER__CHANGE_MASK_HPP_
+#define NAV2_RRTSTAR_PLANNER__CHANGE_MASK_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "nav2_rrtstar_planner/grid_collision.hpp"
+
+namespace nav2_rrtstar_planner {
+
+// Coarse map of the blocks of a grid holding cells that became blocked.
+// A segment can only have been cut by the change if it crosses a marked block,
+// so finding the tree edges to recheck costs a bounds test for most edges and a
+// walk over blocks, rather than cells, for the rest.
+class ChangeMask {
+public:
+    ChangeMask();
+
+    // Marks the blocks around the given row-major cells of grid. Clearing the previous marks
+    // only touches the blocks they set.
+    void reset(const GridView& grid, const std::vector<uint32_t>& blocked_cells);
+
+    bool empty() const { return marked_.empty(); }
+    // Whether the segment may cross one of the blocked cells
+    bool touches(double x0, double y0, double x1, double y1) const;
+    // Cell bounds of the blocked cells, valid when not empty()
+    void cellBounds(unsigned int& min_x, unsigned int& min_y, unsigned int& max_x, unsigned int& max_y) const;
+
+private:
+    static constexpr unsigned int kBlockCells = 8;
+
+    void mark(long block_x, long block_y);
+
+    std::vector<unsigned char> blocks_;
+    std::vector<std::size_t> marked_;
+    GridView view_;
+    unsigned int min_x_, min_y_, max_x_, max_y_;
+    double world_min_x_, world_min_y_, world_max_x_, world_max_y_;
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__CHANGE_MASK_HPP_
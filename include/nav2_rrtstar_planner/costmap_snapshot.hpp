@@ -0,0 +1,39 @@
+#ifndef NAV2_RRTSTAR_PLANNER__COSTMAP_SNAPSHOT_HPP_
+#define NAV2_RRTSTAR_PLANNER__COSTMAP_SNAPSHOT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "nav2_rrtstar_planner/grid_collision.hpp"
+
+namespace nav2_rrtstar_planner {
+
+// Private copy of the costmap cells that planning runs against.
+// update() diffs the live buffer against the copy and keeps the free-cell
+// count current from the cells that actually changed, noting the ones that
+// became blocked; only a change of geometry forces a full recount.
+class CostmapSnapshot {
+public:
+    CostmapSnapshot();
+
+    // Syncs with the live grid; returns true if any cell or the geometry changed.
+    bool update(const GridView& grid);
+
+    const GridView& view() const { return view_; }
+    std::size_t freeCells() const { return free_cells_; }
+    // Row-major indices of the cells that went from free to non-free in the last update(),
+    // empty when it replaced the geometry
+    const std::vector<uint32_t>& newlyBlocked() const { return newly_blocked_; }
+
+private:
+    static std::size_t countFree(const unsigned char* data, std::size_t count);
+
+    std::vector<unsigned char> cells_;
+    std::vector<uint32_t> newly_blocked_;
+    GridView view_;
+    std::size_t free_cells_;
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__COSTMAP_SNAPSHOT_HPP_
@@ -0,0 +1,44 @@
+#ifndef NAV2_RRTSTAR_PLANNER__DISTANCE_FIELD_HPP_
+#define NAV2_RRTSTAR_PLANNER__DISTANCE_FIELD_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "nav2_rrtstar_planner/grid_collision.hpp"
+
+namespace nav2_rrtstar_planner {
+
+// Euclidean distance transform of the non-free cells of a grid.
+// Distances are stored per cell in whole cells (floored), 2 bytes per cell.
+// The caller rebuilds the field when the grid changes, or patches it with the
+// bounding box of newly blocked cells: cells that became free only make the
+// stored distances conservative, so they need no patch.
+class ObstacleDistanceField {
+public:
+    ObstacleDistanceField();
+
+    void build(const GridView& grid);
+    // Caps clearance by the distance to the box of cells [min_x, max_x] x [min_y, max_y]
+    // until the next build()
+    void addObstacleBox(unsigned int min_x, unsigned int min_y, unsigned int max_x, unsigned int max_y);
+    std::size_t obstacleBoxes() const { return boxes_.size(); }
+
+    // Lower bound, in meters, on the distance from (x, y) to any non-free cell or the
+    // map border. Zero when the point is outside the map or inside a non-free cell.
+    double clearance(double x, double y) const;
+
+private:
+    struct Box {
+        double min_x, min_y, max_x, max_y;  // cell units, max exclusive
+    };
+
+    std::vector<uint16_t> distance_;
+    std::vector<Box> boxes_;
+    std::vector<double> row_f_, row_z_;
+    std::vector<int> row_v_;
+    GridView geometry_;
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__DISTANCE_FIELD_HPP_
@@ -0,0 +1,26 @@
+#ifndef NAV2_RRTSTAR_PLANNER__GRID_COLLISION_HPP_
+#define NAV2_RRTSTAR_PLANNER__GRID_COLLISION_HPP_
+
+#include <cstddef>
+
+namespace nav2_rrtstar_planner {
+
+// Read-only view of a row-major occupancy grid, where a cost of 0 means free.
+struct GridView {
+    const unsigned char* data;
+    unsigned int size_x, size_y;
+    double origin_x, origin_y;
+    double resolution;
+};
+
+// Checks the segment from (x0, y0) to (x1, y1) with an Amanatides-Woo traversal:
+// every cell the segment crosses is read exactly once, in order, and the walk stops
+// at the first non-free or out-of-bounds cell.
+bool segmentFree(const GridView& grid, double x0, double y0, double x1, double y1);
+
+// As above, adding the number of cells visited to cells_touched.
+bool segmentFree(const GridView& grid, double x0, double y0, double x1, double y1, std::size_t& cells_touched);
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__GRID_COLLISION_HPP_
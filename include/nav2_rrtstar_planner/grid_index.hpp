@@ -0,0 +1,58 @@
+#ifndef NAV2_RRTSTAR_PLANNER__GRID_INDEX_HPP_
+#define NAV2_RRTSTAR_PLANNER__GRID_INDEX_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace nav2_rrtstar_planner {
+
+// Uniform grid over the planning area for radius queries.
+// Points filed by rebuild are sorted by cell, so each cell's points form one
+// contiguous run; each cell also keeps an intrusive singly linked list of the
+// points inserted since. Inserting never allocates once reserved, and a query
+// only touches the cells overlapping the circle's bounding box.
+class GridIndex {
+public:
+    GridIndex();
+
+    // Clears the index and lays a grid of cell_size cells over the given area.
+    // Points outside the area are clamped into the border cells.
+    void reset(double origin_x, double origin_y, double size_x, double size_y, double cell_size);
+    void reserve(std::size_t capacity);
+    // Lays a grid of cell_size cells over the same area and files every point into its run
+    void rebuild(double cell_size);
+    double cellSize() const { return cell_size_; }
+    std::size_t size() const { return entries_.size(); }
+    // Points in cell runs; the ones inserted since the last rebuild sit in the linked lists
+    std::size_t filedSize() const { return static_cast<std::size_t>(cell_starts_.back()); }
+
+    void insert(double x, double y, int index);
+    // Appends the indices of all points within radius of the center to result.
+    void query(double center_x, double center_y, double radius, std::vector<int>& result) const;
+
+private:
+    struct Entry {
+        double x, y;
+        int index;
+        int next;
+    };
+
+    int cellCoord(double value, double origin, int cells) const;
+    int cellOf(double x, double y) const;
+    void layCells(double cell_size);
+
+    std::vector<int> heads_;
+    std::vector<Entry> entries_;
+    // First entry of each cell's run, with the end of the last run appended
+    std::vector<int> cell_starts_;
+    // Scratch space for rebuild
+    std::vector<Entry> spare_entries_;
+    double origin_x_, origin_y_;
+    double size_x_, size_y_;
+    double cell_size_, inv_cell_size_;
+    int cells_x_, cells_y_;
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__GRID_INDEX_HPP_
@@ -0,0 +1,22 @@
+#ifndef NAV2_RRTSTAR_PLANNER__GRID_MAP_HPP_
+#define NAV2_RRTSTAR_PLANNER__GRID_MAP_HPP_
+
+#include "nav2_rrtstar_planner/grid_collision.hpp"
+
+namespace nav2_rrtstar_planner {
+
+// Occupancy grid the planning core plans on. The core copies the cells out
+// once per plan between lock() and unlock(), so the view only has to stay
+// valid while the map is locked. A map nobody else writes to needs no lock.
+class GridMap {
+public:
+    virtual ~GridMap() = default;
+
+    virtual void lock() {}
+    virtual void unlock() {}
+    virtual GridView view() const = 0;
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__GRID_MAP_HPP_
@@ -0,0 +1,47 @@
+#ifndef NAV2_RRTSTAR_PLANNER__INFORMED_SAMPLER_HPP_
+#define NAV2_RRTSTAR_PLANNER__INFORMED_SAMPLER_HPP_
+
+#include <limits>
+#include <random>
+
+namespace nav2_rrtstar_planner {
+
+// Sample generator for Informed RRT*.
+// Until a solution is known, samples are uniform over the map bounds with every
+// fifth one drawn from a box around the goal. Once a solution of cost c_best
+// exists, samples come uniformly from the ellipse with foci at start and goal
+// and major axis c_best, the only region that can still shorten the path.
+class InformedSampler {
+public:
+    InformedSampler();
+
+    void reset(double min_x, double max_x, double min_y, double max_y,
+               double start_x, double start_y, double goal_x, double goal_y,
+               double goal_bias_extent);
+    void setBestCost(double c_best);
+    // With informed sampling off, samples stay uniform after a solution is found, for comparison
+    void setInformed(bool informed) { informed_ = informed; }
+    double bestCost() const { return c_best_; }
+    bool hasSolution() const { return c_best_ < std::numeric_limits<double>::infinity(); }
+    // Area of the ellipse samples are drawn from, or infinity while they cover the whole map
+    double informedArea() const;
+
+    void sample(std::mt19937& gen, int iteration, double& x, double& y);
+
+private:
+    void sampleEllipse(std::mt19937& gen, double& x, double& y);
+
+    std::uniform_real_distribution<> x_dis_, y_dis_;
+    std::uniform_real_distribution<> goal_x_dis_, goal_y_dis_;
+    std::uniform_real_distribution<> unit_dis_;
+    double center_x_, center_y_;
+    double cos_theta_, sin_theta_;
+    double c_min_;
+    double c_best_;
+    double major_radius_, minor_radius_;
+    bool informed_;
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__INFORMED_SAMPLER_HPP_
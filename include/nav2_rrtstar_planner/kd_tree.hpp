@@ -0,0 +1,50 @@
+#ifndef NAV2_RRTSTAR_PLANNER__KD_TREE_HPP_
+#define NAV2_RRTSTAR_PLANNER__KD_TREE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace nav2_rrtstar_planner {
+
+// Incremental 2D k-d tree over tree vertex indices.
+// Balance is kept scapegoat-style: when an insertion lands deeper than
+// log_{1/alpha}(n), the lowest alpha-unbalanced ancestor on the insertion
+// path is rebuilt around its median, so insertion order cannot degrade
+// queries below O(log n) amortized.
+class KDTree {
+public:
+    explicit KDTree(double alpha = 0.7);
+
+    void clear();
+    void reserve(std::size_t capacity);
+    std::size_t size() const { return nodes_.size(); }
+
+    void insert(double x, double y, int index);
+    // Returns the index of the closest point, or -1 if the tree is empty.
+    int nearest(double x, double y) const;
+
+private:
+    struct Node {
+        double x, y;
+        int index;
+        int left, right;
+        int size;
+        int axis;
+    };
+
+    int maxBalancedDepth() const;
+    void nearestRecursive(int node, double x, double y, int& best, double& best_dist_sq) const;
+    int rebuild(int subtree_root);
+    void collect(int node);
+    int build(std::size_t begin, std::size_t end);
+
+    std::vector<Node> nodes_;
+    std::vector<int> path_;
+    std::vector<int> scratch_;
+    int root_;
+    double alpha_;
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__KD_TREE_HPP_
@@ -0,0 +1,20 @@
+#ifndef NAV2_RRTSTAR_PLANNER__NEAREST_KERNEL_HPP_
+#define NAV2_RRTSTAR_PLANNER__NEAREST_KERNEL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nav2_rrtstar_planner {
+
+// Brute-force nearest point over coordinate columns: argmin of the squared
+// distance to (x, y), ties resolved to the lowest index. The AVX2, SSE2 or
+// scalar implementation is picked once at runtime from the CPU features.
+// Returns UINT32_MAX for an empty range.
+uint32_t nearestBruteForce(const double* xs, const double* ys, std::size_t count, double x, double y);
+
+// Name of the implementation nearestBruteForce dispatches to ("avx2", "sse2" or "scalar").
+const char* nearestKernelName();
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__NEAREST_KERNEL_HPP_
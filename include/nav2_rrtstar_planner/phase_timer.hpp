@@ -0,0 +1,55 @@
+#ifndef NAV2_RRTSTAR_PLANNER__PHASE_TIMER_HPP_
+#define NAV2_RRTSTAR_PLANNER__PHASE_TIMER_HPP_
+
+#include <chrono>
+
+namespace nav2_rrtstar_planner {
+
+// Splits one thread's wall time among phases, each accumulated into a double of seconds.
+// Entering a phase charges the time since the last switch to the phase it interrupts, so
+// nested phases are timed exclusively. A disabled timer never reads the clock.
+class PhaseTimer {
+public:
+    void start(bool enabled) {
+        enabled_ = enabled;
+        current_ = nullptr;
+        if (enabled_) since_ = std::chrono::steady_clock::now();
+    }
+
+    bool enabled() const { return enabled_; }
+
+    // Makes phase (nullptr for none) the current one and returns the phase it replaced
+    double* enter(double* phase) {
+        if (!enabled_) return nullptr;
+        const auto now = std::chrono::steady_clock::now();
+        if (current_) *current_ += std::chrono::duration<double>(now - since_).count();
+        since_ = now;
+        double* previous = current_;
+        current_ = phase;
+        return previous;
+    }
+
+    void stop() { enter(nullptr); }
+
+private:
+    bool enabled_ = false;
+    double* current_ = nullptr;
+    std::chrono::steady_clock::time_point since_;
+};
+
+// Charges its lifetime to phase, then hands the timer back to the phase it interrupted.
+class ScopedPhase {
+public:
+    ScopedPhase(PhaseTimer& timer, double* phase) : timer_(timer), previous_(timer.enter(phase)) {}
+    ~ScopedPhase() { timer_.enter(previous_); }
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+    PhaseTimer& timer_;
+    double* previous_;
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__PHASE_TIMER_HPP_
@@ -0,0 +1,40 @@
+#ifndef NAV2_RRTSTAR_PLANNER__PLAN_STATISTICS_HPP_
+#define NAV2_RRTSTAR_PLANNER__PLAN_STATISTICS_HPP_
+
+#include <cstddef>
+
+namespace nav2_rrtstar_planner {
+
+// Figures collected during one createPlan call.
+struct PlanStatistics {
+    double setup_time = 0.0;  // seconds from entering createPlan until sampling starts
+    double time_to_first_solution = -1.0;  // seconds from entering createPlan, -1 if none was found
+    double planning_time = 0.0;
+    double solution_cost = -1.0;  // cost of the returned path, -1 if none
+    bool costmap_changed = false;
+    std::size_t free_cells = 0;
+    std::size_t blocked_cells = 0;  // cells that went from free to non-free since the previous plan
+    std::size_t reused_vertices = 0;  // vertices carried over from the previous plan's tree
+    unsigned int reattached_vertices = 0;  // reused vertices cut off by a blocked edge and given a new parent
+    unsigned int samples = 0;
+    unsigned int samples_rejected = 0;  // samples dropped because the edge to their nearest vertex was blocked
+    std::size_t vertices = 0;
+    unsigned int edges_checked = 0;
+    unsigned int edges_resolved_by_field = 0;
+    unsigned int edges_repaired = 0;  // lazy mode: edges found blocked on a route and cut from the tree
+    std::size_t cells_touched = 0;  // grid cells visited by edge traversals
+
+    // Seconds spent in each phase, summed over threads; only measured when phase timing is enabled
+    double scan_time = 0.0;  // costmap snapshot, free-space count and distance field update
+    double sampling_time = 0.0;
+    double nearest_time = 0.0;  // nearest-vertex and radius lookups
+    double collision_time = 0.0;
+    double rewire_time = 0.0;  // parent choice and rewiring, without their lookups and edge checks
+    double goal_connection_time = 0.0;
+    double path_extraction_time = 0.0;
+    double smoothing_time = 0.0;  // filled in by the nav2 plugin
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__PLAN_STATISTICS_HPP_
@@ -0,0 +1,237 @@
+#ifndef NAV2_RRTSTAR_PLANNER__PLANNER_CORE_HPP_
+#define NAV2_RRTSTAR_PLANNER__PLANNER_CORE_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "nav2_rrtstar_planner/change_mask.hpp"
+#include "nav2_rrtstar_planner/costmap_snapshot.hpp"
+#include "nav2_rrtstar_planner/distance_field.hpp"
+#include "nav2_rrtstar_planner/grid_collision.hpp"
+#include "nav2_rrtstar_planner/grid_index.hpp"
+#include "nav2_rrtstar_planner/grid_map.hpp"
+#include "nav2_rrtstar_planner/informed_sampler.hpp"
+#include "nav2_rrtstar_planner/kd_tree.hpp"
+#include "nav2_rrtstar_planner/phase_timer.hpp"
+#include "nav2_rrtstar_planner/plan_statistics.hpp"
+#include "nav2_rrtstar_planner/tree.hpp"
+#include "nav2_rrtstar_planner/worker_pool.hpp"
+
+namespace nav2_rrtstar_planner {
+
+// Settings of the planning core; the nav2 plugin fills them from its parameters.
+struct PlannerConfig {
+    int max_iterations = 1000;  // values below 1 are taken as 1
+    double max_planning_time = 0.0;  // seconds; > 0 enables anytime planning until the deadline
+    int nn_brute_force_threshold = 128;
+    bool use_distance_field = true;
+    bool bidirectional = false;
+    int num_threads = 1;
+    bool lazy_collision_checking = false;  // ignored in bidirectional mode
+    bool reuse_tree = false;
+    double max_connection_distance = 2.0;
+    // Seeds every plan with seed and grows in fixed batches, so the route depends only on the
+    // seed, the map, the start and the goal (and with reuse_tree, the plans before it), not on
+    // timing or num_threads; max_planning_time is ignored
+    bool deterministic = false;
+    uint32_t seed = 0;
+    bool time_phases = false;  // fill the per-phase times of PlanStatistics
+    bool informed_sampling = true;  // false keeps sampling the whole map after a solution is found
+};
+
+// Thrown by PlannerCore::plan when no collision-free route to the goal was found.
+class PlanningError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Informed RRT* on an occupancy grid, free of ROS: the sampling, tree and
+// collision logic behind the nav2 plugin, which adapts the costmap to a
+// GridMap and turns the route into a path message.
+class PlannerCore {
+public:
+    PlannerCore();
+    virtual ~PlannerCore() = default;
+
+    void configure(const PlannerConfig& config);
+
+    // Plans on the current cells of map and fills route with the vertices from the start to the
+    // goal. Throws PlanningError if the goal cannot be connected within the budget.
+    void plan(GridMap& map, double start_x, double start_y, double goal_x, double goal_y,
+              std::vector<std::pair<double, double>>& route);
+
+    // Figures of the last plan() call, including a failed one
+    const PlanStatistics& statistics() const { return statistics_; }
+
+protected:
+    // Samples allowed per requested vertex before a fixed-iteration plan gives up growing
+    static constexpr unsigned int kMaxSamplesPerIteration = 20;
+    // Growth rounds a fixed-iteration plan gets to connect the goal before it fails
+    static constexpr int kMaxGoalConnectionRounds = 3;
+    // Largest goal connection radius, as a multiple of max_connection_distance_
+    static constexpr double kGoalConnectionMaxRadiusFactor = 4.0;
+    // Samples each thread prepares per batch in parallel growth
+    static constexpr std::size_t kParallelBatchPerThread = 8;
+    // Samples per batch in deterministic mode, independent of the number of threads
+    static constexpr std::size_t kDeterministicBatchSize = 32;
+    // Goals closer than this to the previous one count as the same goal for tree reuse
+    static constexpr double kReuseGoalTolerance = 0.05;
+    // A reused tree grows by max_iterations / kReuseGrowthDivisor new vertices per plan
+    static constexpr int kReuseGrowthDivisor = 10;
+    // Widens the previous solution cost into a pruning bound once the previous route is blocked
+    static constexpr double kReuseDetourFactor = 1.5;
+    // Marks kept vertices in subtrees that were reattached after a blocked edge cut them off
+    static constexpr uint8_t kReuseReattached = 2;
+    // Marks the vertex re-rooting attaches to the new start
+    static constexpr uint32_t kReuseNewRoot = Tree::kNone - 1;
+    // Patches the distance field takes for newly blocked cells before it is rebuilt
+    static constexpr std::size_t kMaxDistanceFieldBoxes = 4;
+    // Rewire batches smaller than this are checked on the planning thread
+    static constexpr std::size_t kMinParallelEdges = 32;
+    // Vertices inserted into the rewire grid index before it is first re-filed
+    static constexpr std::size_t kMinRefiledVertices = 256;
+    // Collision state of the edge from a new vertex to each of its neighbors
+    static constexpr uint8_t kEdgeUnknown = 0, kEdgeFree = 1, kEdgeBlocked = 2;
+
+    struct Edge {
+        double x0, y0, x1, y1;
+    };
+
+    // A sample prepared by a worker for insertion: its nearest vertex (kNone if that edge is
+    // blocked), its rewire neighbors and the edges to them already checked
+    struct Candidate {
+        double x, y;
+        uint32_t nearest;
+        std::vector<int> neighbors;
+        std::vector<uint8_t> edge_states;
+        std::vector<std::pair<double, std::size_t>> order;
+        unsigned int edges_checked;
+        unsigned int edges_resolved_by_field;
+        std::size_t cells_touched;
+        double nearest_time, collision_time, rewire_time;
+    };
+
+    int max_iterations_;
+    double max_planning_time_;
+    CostmapSnapshot snapshot_;
+    GridView grid_{};
+    ObstacleDistanceField distance_field_;
+    ChangeMask change_mask_;
+    bool use_distance_field_;
+    bool bidirectional_;
+    bool lazy_collision_checking_;
+    bool reuse_tree_;
+    bool deterministic_;
+    uint32_t seed_;
+    bool time_phases_;
+    PhaseTimer phase_timer_;
+    PlanStatistics statistics_;
+    std::mt19937 random_engine_;
+    double goal_x_, goal_y_;
+    // Vertices with a free edge to the goal, and the one currently giving the cheapest route
+    std::vector<uint32_t> goal_candidates_;
+    uint32_t goal_vertex_;
+    // Lazy mode: whether the edge from each vertex to its parent has been checked, and the nearest
+    // vertex it was first attached to over a checked edge
+    std::vector<uint8_t> edge_verified_;
+    std::vector<uint32_t> fallback_parent_;
+    std::vector<uint32_t> repair_subtree_;
+    // Tree reuse: whether the last plan left a tree to continue from, what it planned toward, and
+    // scratch space for pruning and re-rooting it
+    bool tree_reusable_;
+    double previous_goal_x_, previous_goal_y_, previous_solution_cost_;
+    uint32_t previous_goal_vertex_;
+    Tree spare_tree_;
+    std::vector<uint8_t> reuse_keep_;
+    std::vector<double> reuse_bounds_, reuse_ranked_;
+    std::vector<uint32_t> reuse_queue_, reuse_orphans_, reuse_parent_, reuse_head_, reuse_next_, reuse_remap_,
+        reuse_chain_;
+    // Bidirectional mode: the tree rooted at the goal (swapped into tree_ while it is the one
+    // extending), the coincident start/goal tree vertex pairs joining the two, and the goal tree
+    // vertex of the cheapest such pair
+    Tree goal_tree_;
+    KDTree goal_kd_tree_;
+    GridIndex goal_grid_index_;
+    bool trees_swapped_;
+    std::vector<std::pair<uint32_t, uint32_t>> bridges_;
+    uint32_t goal_tree_vertex_;
+    std::chrono::steady_clock::time_point plan_start_, deadline_;
+    Tree tree_;
+    std::vector<int> vertices_inside_circle_;
+    std::vector<uint8_t> edge_states_;
+    std::vector<std::pair<double, std::size_t>> parent_order_;
+    std::vector<Edge> rewire_edges_;
+    std::vector<std::size_t> rewire_slots_;
+    std::vector<uint64_t> rewire_free_mask_;
+    std::vector<uint8_t> chunk_bits_;
+    std::vector<unsigned int> worker_resolved_by_field_;
+    std::vector<std::size_t> worker_cells_touched_;
+    std::vector<double> worker_collision_time_;
+    std::unique_ptr<WorkerPool> worker_pool_;
+    std::vector<Candidate> batch_;
+    KDTree kd_tree_;
+    GridIndex grid_index_;
+    InformedSampler sampler_;
+    double ball_radius_constant_;
+    double free_area_;
+    double max_connection_distance_;
+    int nn_brute_force_threshold_;
+
+    double calculate_distance(double x, double y, uint32_t vertex);
+    uint32_t nearest_neighbor(double x, double y) const;
+    bool connectible(double start_x, double start_y, double end_x, double end_y);
+    bool edgeFree(double start_x, double start_y, double end_x, double end_y,
+                  unsigned int& resolved_by_field, std::size_t& cells_touched) const;
+    void calculateBallRadiusConstant();
+    double calculateBallRadius(int tree_size, int dimensions, double max_connection_distance);
+    // Re-files the rewire grid index into finer cells once the rewire radius has halved
+    void fitRewireCells(double ball_radius);
+    void findVerticesInsideCircle(double center_x, double center_y, double radius,
+                                  std::vector<int>& vertices_inside_circle);
+    double calculate_cost_from_start(uint32_t vertex);
+    bool reuseTree(double start_x, double start_y);
+    // Whether the edges of the previous route, and its edge to the goal, are all still free
+    bool previousRouteFree();
+    // Cost of the cheapest route from the old root to the goal over kept vertices, or infinity
+    double repairedRouteCost();
+    double reuseBound(uint32_t vertex, double start_x, double start_y);
+    // Trims the vertices kept by reuseTree to at most limit, closed under parents
+    void capKeptTree(double start_x, double start_y, std::size_t limit);
+    void keepReachableChildren(uint32_t vertex, double start_x, double start_y, double cost_limit);
+    bool reattachOrphan(uint32_t orphan);
+    // Of the kept vertices within max_connection_distance_ of (x, y), the one with the lowest
+    // cost(vertex) that has a free edge to (x, y), or Tree::kNone; point_is_parent sets the edge's direction
+    template <typename CostFunction>
+    uint32_t cheapestKeptNeighbor(double x, double y, bool point_is_parent, CostFunction cost);
+    void growTree(std::size_t target_size);
+    void growTreeParallel(std::size_t target_size);
+    void prepareCandidate(Candidate& candidate, double ball_radius) const;
+    uint32_t extend(double x, double y, uint32_t nearest, bool& rewired);
+    bool neighborEdgeFree(std::size_t j, double x, double y);
+    uint32_t insertVertex(double x, double y, uint32_t nearest, bool& rewired);
+    void sortByPotentialCost(double x, double y, double cost_bound, const std::vector<int>& neighbors,
+                             std::vector<std::pair<double, std::size_t>>& order) const;
+    // Sets bit i of free_mask when edges[i] is collision free, spreading large batches over the worker pool
+    void checkEdges(const Edge* edges, std::size_t count, std::vector<uint64_t>& free_mask);
+    uint32_t connectTrees(double target_x, double target_y, bool& rewired);
+    void swapTrees();
+    void trackGoal(uint32_t new_vertex, bool rewired);
+    bool validatePath(uint32_t vertex);
+    void repairVertex(uint32_t vertex);
+    uint32_t validatedGoalVertex(double& cost);
+    void trackBridge(uint32_t vertex, uint32_t other_vertex, bool rewired);
+    uint32_t connectGoal();
+    // Fills route with the vertices from the start to the goal: the start tree chain up to
+    // goal_parent, then either the goal itself or the goal tree chain from the vertex coinciding
+    // with goal_parent down to its root at the goal
+    void extractRoute(uint32_t goal_parent, uint32_t goal_tree_vertex, std::vector<std::pair<double, double>>& route);
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__PLANNER_CORE_HPP_
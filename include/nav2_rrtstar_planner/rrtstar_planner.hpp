@@ -2,6 +2,7 @@
 #define NAV2_RRTSTAR_PLANNER__RRTSTAR_PLANNER_HPP_
 
 #include <string>
+#include <utility>
 #include <memory>
 #include <vector>
 #include "rclcpp/rclcpp.hpp"
@@ -10,16 +11,12 @@
 #include "tf2_ros/buffer.h"
 #include "geometry_msgs/msg/pose_stamped.hpp"
 #include "nav_msgs/msg/path.hpp"
+#include "diagnostic_msgs/msg/diagnostic_array.hpp"
+#include "nav2_rrtstar_planner/grid_map.hpp"
+#include "nav2_rrtstar_planner/planner_core.hpp"
 
 namespace nav2_rrtstar_planner {
 
-struct Vertex {
-    double x, y, cost;
-    Vertex* parent;
-    Vertex(double x_val, double y_val, Vertex* p = nullptr, double travel_distance = 0) :
-        x(x_val), y(y_val), parent(p), cost(travel_distance) {}
-};
-
 class RRTStar : public nav2_core::GlobalPlanner {
 public:
     RRTStar() = default;
@@ -36,24 +33,39 @@ public:
                                    const geometry_msgs::msg::PoseStamped& goal) override;
 
 protected:
+    // Presents the costmap to the planning core, holding the costmap's lock while the core
+    // copies the cells
+    class CostmapGridMap : public GridMap {
+    public:
+        explicit CostmapGridMap(nav2_costmap_2d::Costmap2D* costmap) : costmap_(costmap) {}
+
+        void lock() override { costmap_->getMutex()->lock(); }
+        void unlock() override { costmap_->getMutex()->unlock(); }
+        GridView view() const override {
+            return GridView{costmap_->getCharMap(), costmap_->getSizeInCellsX(), costmap_->getSizeInCellsY(),
+                            costmap_->getOriginX(), costmap_->getOriginY(), costmap_->getResolution()};
+        }
+
+    private:
+        nav2_costmap_2d::Costmap2D* costmap_;
+    };
+
     std::shared_ptr<tf2_ros::Buffer> tf_;
     nav2_util::LifecycleNode::SharedPtr node_;
     nav2_costmap_2d::Costmap2D* costmap_;
+    std::unique_ptr<CostmapGridMap> grid_map_;
     std::string global_frame_;
     std::string name_;
-    int max_iterations_;
-    double interpolation_resolution_;
-    std::vector<std::unique_ptr<Vertex>> tree_;
-    double ball_radius_constant_;
+    PlannerCore core_;
+    std::vector<std::pair<double, double>> route_;
+    bool publish_statistics_ = false;
+    rclcpp_lifecycle::LifecyclePublisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr statistics_pub_;
 
-    double calculate_distance(double x, double y, const Vertex& vertex);
-    Vertex* nearest_neighbor(double x, double y);
-    bool connectible(const Vertex& start, const Vertex& end);
-    void calculateBallRadiusConstant();
-    double calculateBallRadius(int tree_size, int dimensions, double max_connection_distance);
-    std::vector<int> findVerticesInsideCircle(double center_x, double center_y, double radius);
-    double calculate_cost_from_start(const Vertex& vertex);
+    void extractPath(const std::vector<std::pair<double, double>>& route,
+                     const geometry_msgs::msg::Quaternion& goal_orientation, nav_msgs::msg::Path& path);
     void smoothPath(nav_msgs::msg::Path& path);
+    // Publishes the figures of one plan, a failed one included, as key-value pairs
+    void publishStatistics(const PlanStatistics& statistics);
     geometry_msgs::msg::PoseStamped computeBezierPoint(const geometry_msgs::msg::PoseStamped& P0,
                                                     const geometry_msgs::msg::PoseStamped& P1,
                                                     const geometry_msgs::msg::PoseStamped& P2,
@@ -0,0 +1,37 @@
+#ifndef NAV2_RRTSTAR_PLANNER__TREE_HPP_
+#define NAV2_RRTSTAR_PLANNER__TREE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nav2_rrtstar_planner {
+
+// Structure-of-arrays storage for the RRT* tree.
+// Vertex i lives at position i of every column; parents and the intrusive
+// child lists are 32-bit indices. Columns are plain vectors of trivial types,
+// so clear() is O(1) and keeps the capacity for the next plan.
+struct Tree {
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr std::size_t kBytesPerVertex =
+        4 * sizeof(double) + 3 * sizeof(uint32_t);
+
+    std::vector<double> x, y;
+    std::vector<double> cost;          // cost of the edge to the parent
+    std::vector<double> cost_to_come;  // sum of edge costs back to the root
+    std::vector<uint32_t> parent, first_child, next_sibling;
+
+    std::size_t size() const { return x.size(); }
+    void clear();
+    void reserve(std::size_t capacity);
+
+    // Appends an unattached vertex and returns its index.
+    uint32_t add(double vx, double vy);
+    // Moves vertex under parent (or detaches it for kNone) and updates the cost-to-come of its subtree.
+    void reparent(uint32_t vertex, uint32_t new_parent, double edge_cost);
+    void propagateCostToDescendants(uint32_t vertex);
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__TREE_HPP_
@@ -0,0 +1,49 @@
+#ifndef NAV2_RRTSTAR_PLANNER__WORKER_POOL_HPP_
+#define NAV2_RRTSTAR_PLANNER__WORKER_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nav2_rrtstar_planner {
+
+// Fixed set of helper threads for data-parallel loops.
+// run() hands out task indices through an atomic counter, so workers claim
+// the next unprocessed index without locking; the calling thread takes part
+// and the call returns once every task has finished.
+class WorkerPool {
+public:
+    // threads counts the calling thread, so a pool of 1 runs everything inline.
+    explicit WorkerPool(std::size_t threads = 1);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    std::size_t size() const { return helpers_.size() + 1; }
+
+    // Calls task(index, worker) for every index in [0, count); worker is in [0, size()).
+    void run(std::size_t count, const std::function<void(std::size_t, std::size_t)>& task);
+
+private:
+    void helperLoop(std::size_t worker);
+    void drain(std::size_t worker);
+
+    std::vector<std::thread> helpers_;
+    std::mutex mutex_;
+    std::condition_variable wake_, done_;
+    const std::function<void(std::size_t, std::size_t)>* task_;
+    std::size_t count_;
+    std::atomic<std::size_t> next_;
+    std::size_t busy_helpers_;
+    std::uint64_t generation_;
+    bool stopping_;
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__WORKER_POOL_HPP_
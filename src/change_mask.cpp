@@ -0,0 +1,83 @@
+#include <algorithm>
+#include "nav2_rrtstar_planner/change_mask.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+constexpr unsigned int ChangeMask::kBlockCells;
+
+ChangeMask::ChangeMask()
+: view_{nullptr, 0, 0, 0.0, 0.0, 0.0}, min_x_(0), min_y_(0), max_x_(0), max_y_(0),
+  world_min_x_(0.0), world_min_y_(0.0), world_max_x_(0.0), world_max_y_(0.0) {}
+
+void ChangeMask::reset(const GridView& grid, const std::vector<uint32_t>& blocked_cells) {
+    const unsigned int blocks_x = (grid.size_x + kBlockCells - 1) / kBlockCells;
+    const unsigned int blocks_y = (grid.size_y + kBlockCells - 1) / kBlockCells;
+    const double block_size = grid.resolution * kBlockCells;
+    if (blocks_x != view_.size_x || blocks_y != view_.size_y || grid.origin_x != view_.origin_x ||
+        grid.origin_y != view_.origin_y || block_size != view_.resolution) {
+        blocks_.assign(static_cast<std::size_t>(blocks_x) * blocks_y, 0);
+        marked_.clear();
+    }
+    for (std::size_t block : marked_) {
+        blocks_[block] = 0;
+    }
+    marked_.clear();
+    view_ = GridView{blocks_.data(), blocks_x, blocks_y, grid.origin_x, grid.origin_y, block_size};
+    if (blocked_cells.empty()) return;
+
+    min_x_ = min_y_ = ~0u;
+    max_x_ = max_y_ = 0;
+    for (uint32_t cell : blocked_cells) {
+        const unsigned int x = cell % grid.size_x;
+        const unsigned int y = cell / grid.size_x;
+        min_x_ = std::min(min_x_, x);
+        min_y_ = std::min(min_y_, y);
+        max_x_ = std::max(max_x_, x);
+        max_y_ = std::max(max_y_, y);
+        // A cell on a block border also marks the block across it, so a segment grazing the shared
+        // corner is caught whichever way the block walk steps past it
+        const long left = static_cast<long>(x == 0 ? 0 : x - 1) / kBlockCells;
+        const long right = static_cast<long>(x + 1) / kBlockCells;
+        const long bottom = static_cast<long>(y == 0 ? 0 : y - 1) / kBlockCells;
+        const long top = static_cast<long>(y + 1) / kBlockCells;
+        for (long block_y = bottom; block_y <= top; ++block_y) {
+            for (long block_x = left; block_x <= right; ++block_x) {
+                mark(block_x, block_y);
+            }
+        }
+    }
+    world_min_x_ = grid.origin_x + min_x_ * grid.resolution;
+    world_min_y_ = grid.origin_y + min_y_ * grid.resolution;
+    world_max_x_ = grid.origin_x + (max_x_ + 1.0) * grid.resolution;
+    world_max_y_ = grid.origin_y + (max_y_ + 1.0) * grid.resolution;
+}
+
+void ChangeMask::mark(long block_x, long block_y) {
+    if (block_x >= static_cast<long>(view_.size_x) || block_y >= static_cast<long>(view_.size_y)) return;
+    const std::size_t block = static_cast<std::size_t>(block_y) * view_.size_x + block_x;
+    if (blocks_[block] == 0) {
+        blocks_[block] = 1;
+        marked_.push_back(block);
+    }
+}
+
+bool ChangeMask::touches(double x0, double y0, double x1, double y1) const {
+    if (marked_.empty()) return false;
+    if (std::max(x0, x1) < world_min_x_ || std::min(x0, x1) > world_max_x_ ||
+        std::max(y0, y1) < world_min_y_ || std::min(y0, y1) > world_max_y_) {
+        return false;
+    }
+    // A marked block reads as an obstacle to the block-level traversal
+    return !segmentFree(view_, x0, y0, x1, y1);
+}
+
+void ChangeMask::cellBounds(unsigned int& min_x, unsigned int& min_y,
+                            unsigned int& max_x, unsigned int& max_y) const {
+    min_x = min_x_;
+    min_y = min_y_;
+    max_x = max_x_;
+    max_y = max_y_;
+}
+
+}  // namespace nav2_rrtstar_planner
@@ -0,0 +1,62 @@
+#include <cstdint>
+#include <cstring>
+#include "nav2_rrtstar_planner/costmap_snapshot.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+CostmapSnapshot::CostmapSnapshot()
+: view_{nullptr, 0, 0, 0.0, 0.0, 0.0}, free_cells_(0) {}
+
+std::size_t CostmapSnapshot::countFree(const unsigned char* data, std::size_t count) {
+    // Branch-free row-major count, which the compiler vectorizes
+    std::size_t free_cells = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        free_cells += data[i] == 0;
+    }
+    return free_cells;
+}
+
+bool CostmapSnapshot::update(const GridView& grid) {
+    const std::size_t count = static_cast<std::size_t>(grid.size_x) * grid.size_y;
+    bool same_geometry = grid.size_x == view_.size_x && grid.size_y == view_.size_y &&
+                         grid.origin_x == view_.origin_x && grid.origin_y == view_.origin_y &&
+                         grid.resolution == view_.resolution && cells_.size() == count;
+    newly_blocked_.clear();
+
+    if (!same_geometry) {
+        cells_.assign(grid.data, grid.data + count);
+        view_ = grid;
+        view_.data = cells_.data();
+        free_cells_ = countFree(cells_.data(), count);
+        return true;
+    }
+
+    if (std::memcmp(cells_.data(), grid.data, count) == 0) {
+        return false;
+    }
+
+    // Compare a word at a time and only touch the bytes of words that differ
+    std::size_t i = 0;
+    for (; i + sizeof(uint64_t) <= count; i += sizeof(uint64_t)) {
+        uint64_t old_word, new_word;
+        std::memcpy(&old_word, &cells_[i], sizeof(uint64_t));
+        std::memcpy(&new_word, &grid.data[i], sizeof(uint64_t));
+        if (old_word == new_word) continue;
+        for (std::size_t j = i; j < i + sizeof(uint64_t); ++j) {
+            if (cells_[j] == 0 && grid.data[j] != 0) newly_blocked_.push_back(static_cast<uint32_t>(j));
+            free_cells_ += (grid.data[j] == 0);
+            free_cells_ -= (cells_[j] == 0);
+            cells_[j] = grid.data[j];
+        }
+    }
+    for (; i < count; ++i) {
+        if (cells_[i] == 0 && grid.data[i] != 0) newly_blocked_.push_back(static_cast<uint32_t>(i));
+        free_cells_ += (grid.data[i] == 0);
+        free_cells_ -= (cells_[i] == 0);
+        cells_[i] = grid.data[i];
+    }
+    return true;
+}
+
+}  // namespace nav2_rrtstar_planner
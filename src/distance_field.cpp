@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "nav2_rrtstar_planner/distance_field.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+namespace
+{
+constexpr uint16_t kFar = std::numeric_limits<uint16_t>::max();
+}  // namespace
+
+ObstacleDistanceField::ObstacleDistanceField()
+: geometry_{nullptr, 0, 0, 0.0, 0.0, 0.0} {}
+
+void ObstacleDistanceField::build(const GridView& grid) {
+    geometry_ = grid;
+    geometry_.data = nullptr;
+    boxes_.clear();
+    const int width = static_cast<int>(grid.size_x);
+    const int height = static_cast<int>(grid.size_y);
+    distance_.assign(static_cast<std::size_t>(width) * height, kFar);
+
+    // Column pass: distance to the nearest non-free cell in the same column, as two row-major sweeps
+    for (int y = 0; y < height; ++y) {
+        uint16_t* row = &distance_[static_cast<std::size_t>(y) * width];
+        const unsigned char* cost = &grid.data[static_cast<std::size_t>(y) * width];
+        const uint16_t* prev = y > 0 ? row - width : nullptr;
+        for (int x = 0; x < width; ++x) {
+            if (cost[x] != 0) {
+                row[x] = 0;
+            } else if (prev != nullptr && prev[x] != kFar) {
+                row[x] = prev[x] + 1;
+            }
+        }
+    }
+    for (int y = height - 2; y >= 0; --y) {
+        uint16_t* row = &distance_[static_cast<std::size_t>(y) * width];
+        const uint16_t* next = row + width;
+        for (int x = 0; x < width; ++x) {
+            if (next[x] != kFar && next[x] + 1 < row[x]) {
+                row[x] = next[x] + 1;
+            }
+        }
+    }
+
+    // Row pass: lower envelope of parabolas (Felzenszwalb-Huttenlocher) over the squared column distances
+    const double inf = std::numeric_limits<double>::infinity();
+    row_f_.resize(width);
+    row_z_.resize(width + 1);
+    row_v_.resize(width);
+    for (int y = 0; y < height; ++y) {
+        uint16_t* row = &distance_[static_cast<std::size_t>(y) * width];
+        for (int x = 0; x < width; ++x) {
+            row_f_[x] = row[x] == kFar ? inf : static_cast<double>(row[x]) * row[x];
+        }
+
+        int k = -1;
+        for (int q = 0; q < width; ++q) {
+            if (row_f_[q] == inf) continue;
+            double s = -inf;
+            while (k >= 0) {
+                int v = row_v_[k];
+                s = ((row_f_[q] + q * q) - (row_f_[v] + v * v)) / (2.0 * (q - v));
+                if (s > row_z_[k]) break;
+                --k;
+            }
+            ++k;
+            row_v_[k] = q;
+            row_z_[k] = k == 0 ? -inf : s;
+            row_z_[k + 1] = inf;
+        }
+
+        if (k < 0) continue;  // no obstacle anywhere in reach of this row
+        int j = 0;
+        for (int q = 0; q < width; ++q) {
+            while (row_z_[j + 1] < q) ++j;
+            int v = row_v_[j];
+            double d = std::sqrt((q - v) * static_cast<double>(q - v) + row_f_[v]);
+            row[q] = d >= kFar ? kFar : static_cast<uint16_t>(d);
+        }
+    }
+}
+
+void ObstacleDistanceField::addObstacleBox(unsigned int min_x, unsigned int min_y,
+                                           unsigned int max_x, unsigned int max_y) {
+    boxes_.push_back(Box{static_cast<double>(min_x), static_cast<double>(min_y),
+                         static_cast<double>(max_x) + 1.0, static_cast<double>(max_y) + 1.0});
+}
+
+double ObstacleDistanceField::clearance(double x, double y) const {
+    if (distance_.empty()) return 0.0;
+    const double gx = (x - geometry_.origin_x) / geometry_.resolution;
+    const double gy = (y - geometry_.origin_y) / geometry_.resolution;
+    if (gx < 0 || gy < 0 || gx >= geometry_.size_x || gy >= geometry_.size_y) return 0.0;
+
+    uint16_t d = distance_[static_cast<std::size_t>(gy) * geometry_.size_x + static_cast<std::size_t>(gx)];
+    if (d == 0) return 0.0;
+
+    // Both the query and the obstacle can sit anywhere in their cells, so give up one cell diagonal
+    double cells = static_cast<double>(d) - M_SQRT2;
+    // Cells blocked since the build lie somewhere in their boxes; the distance to a box is exact
+    for (const Box& box : boxes_) {
+        double box_dx = std::max(std::max(box.min_x - gx, gx - box.max_x), 0.0);
+        double box_dy = std::max(std::max(box.min_y - gy, gy - box.max_y), 0.0);
+        cells = std::min(cells, std::sqrt(box_dx * box_dx + box_dy * box_dy));
+    }
+    double border = std::min(std::min(gx, gy), std::min(geometry_.size_x - gx, geometry_.size_y - gy));
+    return std::max(0.0, std::min(cells, border)) * geometry_.resolution;
+}
+
+}  // namespace nav2_rrtstar_planner
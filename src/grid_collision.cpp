@@ -0,0 +1,60 @@
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include "nav2_rrtstar_planner/grid_collision.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+bool segmentFree(const GridView& grid, double x0, double y0, double x1, double y1) {
+    std::size_t cells_touched = 0;
+    return segmentFree(grid, x0, y0, x1, y1, cells_touched);
+}
+
+bool segmentFree(const GridView& grid, double x0, double y0, double x1, double y1, std::size_t& cells_touched) {
+    // Work in cell units
+    const double gx0 = (x0 - grid.origin_x) / grid.resolution;
+    const double gy0 = (y0 - grid.origin_y) / grid.resolution;
+    const double gx1 = (x1 - grid.origin_x) / grid.resolution;
+    const double gy1 = (y1 - grid.origin_y) / grid.resolution;
+
+    long cx = static_cast<long>(std::floor(gx0));
+    long cy = static_cast<long>(std::floor(gy0));
+    const long end_x = static_cast<long>(std::floor(gx1));
+    const long end_y = static_cast<long>(std::floor(gy1));
+
+    const double dx = gx1 - gx0;
+    const double dy = gy1 - gy0;
+    const long step_x = dx > 0 ? 1 : -1;
+    const long step_y = dy > 0 ? 1 : -1;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    // Parametric distance along the segment to the next vertical / horizontal cell boundary
+    const double t_delta_x = dx != 0 ? std::abs(1.0 / dx) : inf;
+    const double t_delta_y = dy != 0 ? std::abs(1.0 / dy) : inf;
+    double t_max_x = dx > 0 ? (cx + 1 - gx0) * t_delta_x : (dx < 0 ? (gx0 - cx) * t_delta_x : inf);
+    double t_max_y = dy > 0 ? (cy + 1 - gy0) * t_delta_y : (dy < 0 ? (gy0 - cy) * t_delta_y : inf);
+
+    // Exactly one step per crossed boundary, so the walk ends in the end point's cell
+    const long steps = std::labs(end_x - cx) + std::labs(end_y - cy);
+    long remaining = steps;
+    while (true) {
+        if (cx < 0 || cy < 0 || cx >= static_cast<long>(grid.size_x) || cy >= static_cast<long>(grid.size_y) ||
+            grid.data[cy * static_cast<long>(grid.size_x) + cx] != 0) {
+            cells_touched += steps - remaining + 1;
+            return false;
+        }
+        if (remaining-- == 0) break;
+        if (t_max_x < t_max_y) {
+            cx += step_x;
+            t_max_x += t_delta_x;
+        } else {
+            cy += step_y;
+            t_max_y += t_delta_y;
+        }
+    }
+    cells_touched += steps + 1;
+    return true;
+}
+
+}  // namespace nav2_rrtstar_planner
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "nav2_rrtstar_planner/grid_index.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+GridIndex::GridIndex()
+: heads_(1, -1), cell_starts_(2, 0), origin_x_(0.0), origin_y_(0.0), size_x_(1.0), size_y_(1.0), cell_size_(1.0), inv_cell_size_(1.0),
+  cells_x_(1), cells_y_(1) {}
+
+void GridIndex::reset(double origin_x, double origin_y, double size_x, double size_y, double cell_size) {
+    origin_x_ = origin_x;
+    origin_y_ = origin_y;
+    size_x_ = size_x;
+    size_y_ = size_y;
+    layCells(cell_size);
+    entries_.clear();
+    cell_starts_.assign(heads_.size() + 1, 0);
+}
+
+void GridIndex::reserve(std::size_t capacity) {
+    entries_.reserve(capacity);
+    spare_entries_.reserve(capacity);
+}
+
+void GridIndex::rebuild(double cell_size) {
+    layCells(cell_size);
+    // Counting sort by cell, so each cell's points form one contiguous run that a query scans
+    // without chasing links; heads_ serves as the write cursor of every run meanwhile
+    cell_starts_.assign(heads_.size() + 1, 0);
+    for (const Entry& entry : entries_) {
+        cell_starts_[cellOf(entry.x, entry.y) + 1]++;
+    }
+    std::partial_sum(cell_starts_.begin(), cell_starts_.end(), cell_starts_.begin());
+    std::copy(cell_starts_.begin(), cell_starts_.end() - 1, heads_.begin());
+    spare_entries_.resize(entries_.size());
+    for (const Entry& entry : entries_) {
+        spare_entries_[heads_[cellOf(entry.x, entry.y)]++] = entry;
+    }
+    entries_.swap(spare_entries_);
+    std::fill(heads_.begin(), heads_.end(), -1);
+}
+
+void GridIndex::layCells(double cell_size) {
+    cell_size_ = cell_size;
+    inv_cell_size_ = 1.0 / cell_size;
+    cells_x_ = std::max(1, static_cast<int>(std::ceil(size_x_ * inv_cell_size_)));
+    cells_y_ = std::max(1, static_cast<int>(std::ceil(size_y_ * inv_cell_size_)));
+    heads_.assign(static_cast<std::size_t>(cells_x_) * cells_y_, -1);
+}
+
+int GridIndex::cellCoord(double value, double origin, int cells) const {
+    int cell = static_cast<int>(std::floor((value - origin) * inv_cell_size_));
+    return std::min(std::max(cell, 0), cells - 1);
+}
+
+int GridIndex::cellOf(double x, double y) const {
+    return cellCoord(y, origin_y_, cells_y_) * cells_x_ + cellCoord(x, origin_x_, cells_x_);
+}
+
+void GridIndex::insert(double x, double y, int index) {
+    int cell = cellOf(x, y);
+    entries_.push_back(Entry{x, y, index, heads_[cell]});
+    heads_[cell] = static_cast<int>(entries_.size()) - 1;
+}
+
+void GridIndex::query(double center_x, double center_y, double radius, std::vector<int>& result) const {
+    double radius_squared = radius * radius;
+    int min_cx = cellCoord(center_x - radius, origin_x_, cells_x_);
+    int max_cx = cellCoord(center_x + radius, origin_x_, cells_x_);
+    int min_cy = cellCoord(center_y - radius, origin_y_, cells_y_);
+    int max_cy = cellCoord(center_y + radius, origin_y_, cells_y_);
+
+    auto visit = [&](const Entry& entry) {
+        double dx = entry.x - center_x;
+        double dy = entry.y - center_y;
+        if (dx * dx + dy * dy <= radius_squared) {
+            result.push_back(entry.index);
+        }
+    };
+    for (int cy = min_cy; cy <= max_cy; ++cy) {
+        // The runs of a row's cells are adjacent, so the filed points of the row are one range
+        const int row = cy * cells_x_;
+        for (int e = cell_starts_[row + min_cx]; e < cell_starts_[row + max_cx + 1]; ++e) {
+            visit(entries_[e]);
+        }
+        for (int cx = min_cx; cx <= max_cx; ++cx) {
+            for (int e = heads_[row + cx]; e != -1; e = entries_[e].next) {
+                visit(entries_[e]);
+            }
+        }
+    }
+}
+
+}  // namespace nav2_rrtstar_planner
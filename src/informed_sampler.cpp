@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <cmath>
+#include "nav2_rrtstar_planner/informed_sampler.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+InformedSampler::InformedSampler()
+: unit_dis_(0.0, 1.0), center_x_(0.0), center_y_(0.0), cos_theta_(1.0), sin_theta_(0.0),
+  c_min_(0.0), c_best_(std::numeric_limits<double>::infinity()),
+  major_radius_(0.0), minor_radius_(0.0), informed_(true) {}
+
+void InformedSampler::reset(double min_x, double max_x, double min_y, double max_y,
+                            double start_x, double start_y, double goal_x, double goal_y,
+                            double goal_bias_extent) {
+    x_dis_ = std::uniform_real_distribution<>(min_x, max_x);
+    y_dis_ = std::uniform_real_distribution<>(min_y, max_y);
+    goal_x_dis_ = std::uniform_real_distribution<>(goal_x - goal_bias_extent, goal_x + goal_bias_extent);
+    goal_y_dis_ = std::uniform_real_distribution<>(goal_y - goal_bias_extent, goal_y + goal_bias_extent);
+
+    center_x_ = 0.5 * (start_x + goal_x);
+    center_y_ = 0.5 * (start_y + goal_y);
+    c_min_ = std::hypot(goal_x - start_x, goal_y - start_y);
+    double theta = std::atan2(goal_y - start_y, goal_x - start_x);
+    cos_theta_ = std::cos(theta);
+    sin_theta_ = std::sin(theta);
+    c_best_ = std::numeric_limits<double>::infinity();
+}
+
+void InformedSampler::setBestCost(double c_best) {
+    c_best_ = c_best;
+    major_radius_ = 0.5 * c_best_;
+    minor_radius_ = 0.5 * std::sqrt(std::max(0.0, c_best_ * c_best_ - c_min_ * c_min_));
+}
+
+double InformedSampler::informedArea() const {
+    if (!informed_ || !hasSolution()) return std::numeric_limits<double>::infinity();
+    return M_PI * major_radius_ * minor_radius_;
+}
+
+void InformedSampler::sample(std::mt19937& gen, int iteration, double& x, double& y) {
+    if (informed_ && hasSolution()) {
+        sampleEllipse(gen, x, y);
+    } else if (iteration % 5 == 0) {
+        x = goal_x_dis_(gen);
+        y = goal_y_dis_(gen);
+    } else {
+        x = x_dis_(gen);
+        y = y_dis_(gen);
+    }
+}
+
+void InformedSampler::sampleEllipse(std::mt19937& gen, double& x, double& y) {
+    // Uniform point in the unit disk, stretched onto the ellipse and rotated onto the start-goal axis
+    double r = std::sqrt(unit_dis_(gen));
+    double phi = 2.0 * M_PI * unit_dis_(gen);
+    double ex = major_radius_ * r * std::cos(phi);
+    double ey = minor_radius_ * r * std::sin(phi);
+    x = center_x_ + cos_theta_ * ex - sin_theta_ * ey;
+    y = center_y_ + sin_theta_ * ex + cos_theta_ * ey;
+}
+
+}  // namespace nav2_rrtstar_planner
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "nav2_rrtstar_planner/kd_tree.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+KDTree::KDTree(double alpha) : root_(-1), alpha_(alpha) {}
+
+void KDTree::clear() {
+    nodes_.clear();
+    root_ = -1;
+}
+
+void KDTree::reserve(std::size_t capacity) {
+    nodes_.reserve(capacity);
+    path_.reserve(64);
+    scratch_.reserve(capacity);
+}
+
+int KDTree::maxBalancedDepth() const {
+    return static_cast<int>(std::log(static_cast<double>(nodes_.size())) / std::log(1.0 / alpha_)) + 1;
+}
+
+void KDTree::insert(double x, double y, int index) {
+    const int id = static_cast<int>(nodes_.size());
+    nodes_.push_back(Node{x, y, index, -1, -1, 1, 0});
+    if (root_ == -1) {
+        root_ = id;
+        return;
+    }
+
+    // Descend to the leaf, growing subtree sizes along the way
+    path_.clear();
+    int cur = root_;
+    while (true) {
+        path_.push_back(cur);
+        Node& node = nodes_[cur];
+        node.size++;
+        bool go_left = (node.axis == 0) ? x < node.x : y < node.y;
+        int& next = go_left ? node.left : node.right;
+        if (next == -1) {
+            next = id;
+            nodes_[id].axis = 1 - node.axis;
+            break;
+        }
+        cur = next;
+    }
+
+    if (static_cast<int>(path_.size()) <= maxBalancedDepth()) return;
+
+    // Find the scapegoat: lowest ancestor whose heavier child exceeds alpha of its size
+    for (int i = static_cast<int>(path_.size()) - 1; i >= 0; --i) {
+        const Node& node = nodes_[path_[i]];
+        int left_size = node.left == -1 ? 0 : nodes_[node.left].size;
+        int right_size = node.right == -1 ? 0 : nodes_[node.right].size;
+        if (std::max(left_size, right_size) > alpha_ * node.size) {
+            int new_root = rebuild(path_[i]);
+            if (i == 0) {
+                root_ = new_root;
+            } else {
+                Node& parent = nodes_[path_[i - 1]];
+                (parent.left == path_[i] ? parent.left : parent.right) = new_root;
+            }
+            return;
+        }
+    }
+}
+
+int KDTree::rebuild(int subtree_root) {
+    scratch_.clear();
+    collect(subtree_root);
+    return build(0, scratch_.size());
+}
+
+void KDTree::collect(int node) {
+    if (node == -1) return;
+    scratch_.push_back(node);
+    collect(nodes_[node].left);
+    collect(nodes_[node].right);
+}
+
+int KDTree::build(std::size_t begin, std::size_t end) {
+    if (begin >= end) return -1;
+
+    // Split along the axis with the larger spread
+    double min_x = std::numeric_limits<double>::infinity(), max_x = -min_x;
+    double min_y = min_x, max_y = -min_x;
+    for (std::size_t i = begin; i < end; ++i) {
+        const Node& node = nodes_[scratch_[i]];
+        min_x = std::min(min_x, node.x);
+        max_x = std::max(max_x, node.x);
+        min_y = std::min(min_y, node.y);
+        max_y = std::max(max_y, node.y);
+    }
+    const int axis = (max_x - min_x >= max_y - min_y) ? 0 : 1;
+
+    std::size_t mid = begin + (end - begin) / 2;
+    std::nth_element(scratch_.begin() + begin, scratch_.begin() + mid, scratch_.begin() + end,
+        [this, axis](int a, int b) {
+            return axis == 0 ? nodes_[a].x < nodes_[b].x : nodes_[a].y < nodes_[b].y;
+        });
+
+    const int id = scratch_[mid];
+    nodes_[id].axis = axis;
+    nodes_[id].size = static_cast<int>(end - begin);
+    nodes_[id].left = build(begin, mid);
+    nodes_[id].right = build(mid + 1, end);
+    return id;
+}
+
+int KDTree::nearest(double x, double y) const {
+    int best = -1;
+    double best_dist_sq = std::numeric_limits<double>::infinity();
+    nearestRecursive(root_, x, y, best, best_dist_sq);
+    return best == -1 ? -1 : nodes_[best].index;
+}
+
+void KDTree::nearestRecursive(int node, double x, double y, int& best, double& best_dist_sq) const {
+    if (node == -1) return;
+    const Node& n = nodes_[node];
+
+    double dx = n.x - x;
+    double dy = n.y - y;
+    double dist_sq = dx * dx + dy * dy;
+    if (dist_sq < best_dist_sq) {
+        best_dist_sq = dist_sq;
+        best = node;
+    }
+
+    // Visit the side containing the query first, the other only if the splitting line is closer than the best
+    double diff = (n.axis == 0) ? x - n.x : y - n.y;
+    int near_side = diff < 0 ? n.left : n.right;
+    int far_side = diff < 0 ? n.right : n.left;
+    nearestRecursive(near_side, x, y, best, best_dist_sq);
+    if (diff * diff < best_dist_sq) {
+        nearestRecursive(far_side, x, y, best, best_dist_sq);
+    }
+}
+
+}  // namespace nav2_rrtstar_planner
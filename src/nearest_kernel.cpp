@@ -0,0 +1,147 @@
+#include <limits>
+#include "nav2_rrtstar_planner/nearest_kernel.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RRTSTAR_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace nav2_rrtstar_planner
+{
+
+namespace
+{
+
+using Kernel = uint32_t (*)(const double*, const double*, std::size_t, double, double);
+
+uint32_t nearestScalar(const double* xs, const double* ys, std::size_t count, double x, double y) {
+    uint32_t best = UINT32_MAX;
+    double best_dist_sq = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < count; ++i) {
+        double dx = xs[i] - x;
+        double dy = ys[i] - y;
+        double dist_sq = dx * dx + dy * dy;
+        if (dist_sq < best_dist_sq) {
+            best_dist_sq = dist_sq;
+            best = static_cast<uint32_t>(i);
+        }
+    }
+    return best;
+}
+
+#ifdef RRTSTAR_X86_KERNELS
+
+// Picks the best lane, then lets the scalar tail compete against it
+uint32_t reduceLanes(const double* lane_dist, const double* lane_index, int lanes,
+                     const double* xs, const double* ys, std::size_t begin, std::size_t count,
+                     double x, double y) {
+    uint32_t best = UINT32_MAX;
+    double best_dist_sq = std::numeric_limits<double>::infinity();
+    for (int l = 0; l < lanes; ++l) {
+        uint32_t index = static_cast<uint32_t>(lane_index[l]);
+        // Lanes that saw no point still hold their initial infinite distance
+        if (lane_dist[l] < best_dist_sq ||
+            (lane_dist[l] == best_dist_sq && best != UINT32_MAX && index < best)) {
+            best_dist_sq = lane_dist[l];
+            best = index;
+        }
+    }
+    for (std::size_t i = begin; i < count; ++i) {
+        double dx = xs[i] - x;
+        double dy = ys[i] - y;
+        double dist_sq = dx * dx + dy * dy;
+        if (dist_sq < best_dist_sq) {
+            best_dist_sq = dist_sq;
+            best = static_cast<uint32_t>(i);
+        }
+    }
+    return best;
+}
+
+uint32_t nearestSse2(const double* xs, const double* ys, std::size_t count, double x, double y) {
+    const __m128d qx = _mm_set1_pd(x);
+    const __m128d qy = _mm_set1_pd(y);
+    const __m128d step = _mm_set1_pd(2.0);
+    __m128d best = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    __m128d best_index = _mm_setzero_pd();
+    __m128d index = _mm_set_pd(1.0, 0.0);
+
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), qx);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), qy);
+        __m128d dist_sq = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        __m128d closer = _mm_cmplt_pd(dist_sq, best);
+        best = _mm_or_pd(_mm_and_pd(closer, dist_sq), _mm_andnot_pd(closer, best));
+        best_index = _mm_or_pd(_mm_and_pd(closer, index), _mm_andnot_pd(closer, best_index));
+        index = _mm_add_pd(index, step);
+    }
+
+    alignas(16) double lane_dist[2], lane_index[2];
+    _mm_store_pd(lane_dist, best);
+    _mm_store_pd(lane_index, best_index);
+    return reduceLanes(lane_dist, lane_index, 2, xs, ys, i, count, x, y);
+}
+
+__attribute__((target("avx2")))
+uint32_t nearestAvx2(const double* xs, const double* ys, std::size_t count, double x, double y) {
+    const __m256d qx = _mm256_set1_pd(x);
+    const __m256d qy = _mm256_set1_pd(y);
+    const __m256d step = _mm256_set1_pd(4.0);
+    __m256d best = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d best_index = _mm256_setzero_pd();
+    __m256d index = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), qx);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), qy);
+        __m256d dist_sq = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        __m256d closer = _mm256_cmp_pd(dist_sq, best, _CMP_LT_OQ);
+        best = _mm256_blendv_pd(best, dist_sq, closer);
+        best_index = _mm256_blendv_pd(best_index, index, closer);
+        index = _mm256_add_pd(index, step);
+    }
+
+    alignas(32) double lane_dist[4], lane_index[4];
+    _mm256_store_pd(lane_dist, best);
+    _mm256_store_pd(lane_index, best_index);
+    return reduceLanes(lane_dist, lane_index, 4, xs, ys, i, count, x, y);
+}
+
+#endif  // RRTSTAR_X86_KERNELS
+
+struct Dispatch {
+    Kernel kernel;
+    const char* name;
+};
+
+Dispatch selectKernel() {
+#ifdef RRTSTAR_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {nearestAvx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {nearestSse2, "sse2"};
+    }
+#endif
+    return {nearestScalar, "scalar"};
+}
+
+const Dispatch& dispatch() {
+    static const Dispatch selected = selectKernel();
+    return selected;
+}
+
+}  // namespace
+
+uint32_t nearestBruteForce(const double* xs, const double* ys, std::size_t count, double x, double y) {
+    return dispatch().kernel(xs, ys, count, x, y);
+}
+
+const char* nearestKernelName() {
+    return dispatch().name;
+}
+
+}  // namespace nav2_rrtstar_planner
@@ -0,0 +1,1144 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <string>
+#include "nav2_rrtstar_planner/nearest_kernel.hpp"
+#include "nav2_rrtstar_planner/planner_core.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+namespace
+{
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+constexpr unsigned int PlannerCore::kMaxSamplesPerIteration;
+constexpr int PlannerCore::kMaxGoalConnectionRounds;
+constexpr double PlannerCore::kGoalConnectionMaxRadiusFactor;
+constexpr std::size_t PlannerCore::kParallelBatchPerThread;
+constexpr std::size_t PlannerCore::kDeterministicBatchSize;
+constexpr double PlannerCore::kReuseGoalTolerance;
+constexpr int PlannerCore::kReuseGrowthDivisor;
+constexpr double PlannerCore::kReuseDetourFactor;
+constexpr uint8_t PlannerCore::kReuseReattached;
+constexpr uint32_t PlannerCore::kReuseNewRoot;
+constexpr std::size_t PlannerCore::kMaxDistanceFieldBoxes;
+constexpr std::size_t PlannerCore::kMinParallelEdges;
+constexpr std::size_t PlannerCore::kMinRefiledVertices;
+constexpr uint8_t PlannerCore::kEdgeUnknown;
+constexpr uint8_t PlannerCore::kEdgeFree;
+constexpr uint8_t PlannerCore::kEdgeBlocked;
+
+PlannerCore::PlannerCore()
+: worker_pool_(std::make_unique<WorkerPool>()) {
+    configure(PlannerConfig());
+}
+
+void PlannerCore::configure(const PlannerConfig& config) {
+    // Out-of-range budgets are clamped: at least one vertex, and no deadline rather than a past one
+    max_iterations_ = std::max(config.max_iterations, 1);
+    // A wall-clock deadline would make the amount of growth depend on the machine's load
+    max_planning_time_ = config.deterministic || !(config.max_planning_time > 0.0) ? 0.0 : config.max_planning_time;
+    nn_brute_force_threshold_ = config.nn_brute_force_threshold;
+    use_distance_field_ = config.use_distance_field;
+    bidirectional_ = config.bidirectional;
+    lazy_collision_checking_ = config.lazy_collision_checking && !config.bidirectional;
+    reuse_tree_ = config.reuse_tree;
+    deterministic_ = config.deterministic;
+    seed_ = config.seed;
+    time_phases_ = config.time_phases;
+    sampler_.setInformed(config.informed_sampling);
+    max_connection_distance_ = config.max_connection_distance;
+    if (worker_pool_->size() != static_cast<std::size_t>(std::max(config.num_threads, 1))) {
+        worker_pool_ = std::make_unique<WorkerPool>(static_cast<std::size_t>(std::max(config.num_threads, 1)));
+    }
+    tree_reusable_ = false;
+}
+
+void PlannerCore::plan(GridMap& map, double start_x, double start_y, double goal_x, double goal_y,
+                       std::vector<std::pair<double, double>>& route) {
+    const auto plan_start = std::chrono::steady_clock::now();
+    statistics_ = PlanStatistics();
+    phase_timer_.start(time_phases_);
+    phase_timer_.enter(&statistics_.scan_time);
+
+    // Planning runs against a private copy of the cells; the map is only held while it is synced
+    {
+        std::lock_guard<GridMap> lock(map);
+        statistics_.costmap_changed = snapshot_.update(map.view());
+    }
+    const GridView previous_grid = grid_;
+    grid_ = snapshot_.view();
+    bool same_grid = previous_grid.size_x == grid_.size_x && previous_grid.size_y == grid_.size_y &&
+                     previous_grid.origin_x == grid_.origin_x && previous_grid.origin_y == grid_.origin_y &&
+                     previous_grid.resolution == grid_.resolution;
+    statistics_.free_cells = snapshot_.freeCells();
+    statistics_.blocked_cells = snapshot_.newlyBlocked().size();
+    change_mask_.reset(grid_, snapshot_.newlyBlocked());
+    if (statistics_.costmap_changed) {
+        // Cells blocked on an unchanged grid patch the distance field with their bounding box; a
+        // full rebuild only follows a new geometry, a box too large to leave much of the fast
+        // path, or too many patches
+        if (use_distance_field_) {
+            unsigned int min_x, min_y, max_x, max_y;
+            if (!change_mask_.empty()) change_mask_.cellBounds(min_x, min_y, max_x, max_y);
+            if (!same_grid || distance_field_.obstacleBoxes() >= kMaxDistanceFieldBoxes ||
+                (!change_mask_.empty() && (max_x - min_x + 1.0) * (max_y - min_y + 1.0) * 4.0 >
+                                              static_cast<double>(grid_.size_x) * grid_.size_y)) {
+                distance_field_.build(grid_);
+            } else if (!change_mask_.empty()) {
+                distance_field_.addObstacleBox(min_x, min_y, max_x, max_y);
+            }
+        }
+        calculateBallRadiusConstant();
+    }
+    phase_timer_.enter(nullptr);
+
+    // Set up a random position generator
+    if (deterministic_) {
+        random_engine_.seed(seed_);
+    } else {
+        std::random_device rd;
+        random_engine_.seed(rd());
+    }
+    sampler_.reset(grid_.origin_x, grid_.origin_x + grid_.size_x * grid_.resolution,
+                   grid_.origin_y, grid_.origin_y + grid_.size_y * grid_.resolution,
+                   start_x, start_y,
+                   goal_x, goal_y, 5.0);
+
+    // The goal is kept outside the tree; growth tracks the cheapest vertex with a free edge to it
+    goal_x_ = goal_x;
+    goal_y_ = goal_y;
+    goal_candidates_.clear();
+    goal_vertex_ = Tree::kNone;
+    plan_start_ = plan_start;
+
+    // Replanning toward the same goal on the same grid continues from the previous tree, rechecking
+    // only the edges near newly blocked cells, and in lazy mode the ones never checked
+    bool warm_start = reuse_tree_ && tree_reusable_ && !bidirectional_ && same_grid &&
+                      std::hypot(goal_x_ - previous_goal_x_, goal_y_ - previous_goal_y_) <= kReuseGoalTolerance &&
+                      reuseTree(start_x, start_y);
+    tree_reusable_ = false;
+    if (!warm_start) {
+        // Tree columns keep their capacity from the previous plan
+        tree_.clear();
+        tree_.reserve(max_iterations_);
+
+        // Add start position to the tree
+        tree_.add(start_x, start_y);
+        kd_tree_.clear();
+        kd_tree_.reserve(max_iterations_);
+        kd_tree_.insert(start_x, start_y, 0);
+
+        // Rewire queries never exceed max_connection_distance_, so one cell of that size keeps them to a
+        // 3x3 block; fitRewireCells shrinks the cells along with the rewire radius as the tree grows
+        grid_index_.reset(grid_.origin_x, grid_.origin_y,
+                          grid_.size_x * grid_.resolution, grid_.size_y * grid_.resolution,
+                          max_connection_distance_);
+        grid_index_.reserve(max_iterations_);
+        grid_index_.insert(start_x, start_y, 0);
+
+        edge_verified_.assign(lazy_collision_checking_ ? 1 : 0, 1);
+        fallback_parent_.assign(lazy_collision_checking_ ? 1 : 0, Tree::kNone);
+    }
+    statistics_.reused_vertices = warm_start ? tree_.size() : 0;
+
+    // In bidirectional mode a second tree grows from the goal, and solutions are the bridges between them
+    goal_tree_.clear();
+    goal_kd_tree_.clear();
+    bridges_.clear();
+    goal_tree_vertex_ = Tree::kNone;
+    trees_swapped_ = false;
+    if (bidirectional_) {
+        goal_tree_.reserve(max_iterations_);
+        goal_tree_.add(goal_x_, goal_y_);
+        goal_kd_tree_.reserve(max_iterations_);
+        goal_kd_tree_.insert(goal_x_, goal_y_, 0);
+        goal_grid_index_.reset(grid_.origin_x, grid_.origin_y,
+                               grid_.size_x * grid_.resolution, grid_.size_y * grid_.resolution,
+                               max_connection_distance_);
+        goal_grid_index_.reserve(max_iterations_);
+        goal_grid_index_.insert(goal_x_, goal_y_, 0);
+    }
+    deadline_ = plan_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(max_planning_time_));
+
+    statistics_.setup_time = secondsSince(plan_start);
+
+    // Grow, then take the tracked goal vertex, or search a wider ring around the goal when growth
+    // never came within connection range. If no vertex can reach it, grow further and retry a
+    // bounded number of times (or until the time budget runs out) before giving up.
+    const bool anytime = max_planning_time_ > 0.0;
+    // A warm-started tree only grows by a fraction of max_iterations to refine the kept one
+    std::size_t target_size = warm_start ?
+        tree_.size() + std::max<std::size_t>(max_iterations_ / kReuseGrowthDivisor, 1) : max_iterations_;
+    uint32_t goal_parent = Tree::kNone;
+    for (int round = 1; ; ++round) {
+        // Deterministic mode always grows in batches, so a single thread builds the same tree as many
+        if ((worker_pool_->size() > 1 || deterministic_) && !bidirectional_ && !lazy_collision_checking_) {
+            growTreeParallel(target_size);
+        } else {
+            growTree(target_size);
+        }
+        {
+            ScopedPhase phase(phase_timer_, &statistics_.goal_connection_time);
+            goal_parent = goal_vertex_ != Tree::kNone || bidirectional_ ? goal_vertex_ : connectGoal();
+            // Rewires since the route was accepted may have moved it onto unchecked edges
+            if (lazy_collision_checking_ && goal_parent != Tree::kNone && !validatePath(goal_parent)) {
+                double cost;
+                goal_parent = validatedGoalVertex(cost);
+            }
+        }
+        if (goal_parent != Tree::kNone) break;
+
+        bool out_of_budget = anytime ? std::chrono::steady_clock::now() >= deadline_ : round >= kMaxGoalConnectionRounds;
+        if (out_of_budget) {
+            statistics_.vertices = tree_.size() + goal_tree_.size();
+            statistics_.planning_time = secondsSince(plan_start);
+            throw PlanningError(
+                    "RRTStar: no collision-free connection to the goal after growing " +
+                    std::to_string(tree_.size() + goal_tree_.size()) + " vertices");
+        }
+        target_size += max_iterations_;
+    }
+    statistics_.vertices = tree_.size() + goal_tree_.size();
+    statistics_.solution_cost = calculate_cost_from_start(goal_parent) + (bidirectional_ ?
+        goal_tree_.cost_to_come[goal_tree_vertex_] : calculate_distance(goal_x_, goal_y_, goal_parent));
+
+    {
+        ScopedPhase phase(phase_timer_, &statistics_.path_extraction_time);
+        extractRoute(goal_parent, goal_tree_vertex_, route);
+    }
+
+    tree_reusable_ = !bidirectional_;
+    previous_goal_x_ = goal_x_;
+    previous_goal_y_ = goal_y_;
+    previous_goal_vertex_ = goal_parent;
+    previous_solution_cost_ = statistics_.solution_cost;
+
+    statistics_.planning_time = secondsSince(plan_start);
+}
+
+void PlannerCore::calculateBallRadiusConstant() {
+    double resolution = grid_.resolution;
+    double cellArea = resolution * resolution;
+    // Maintained by the snapshot from the cells that changed since the last plan
+    std::size_t numFreeCells = snapshot_.freeCells();
+
+    // gamma = 2 (1 + 1/d)^(1/d) (mu_free / zeta_d)^(1/d), the smallest constant for which the
+    // rewire radius keeps RRT* asymptotically optimal (Karaman and Frazzoli)
+    free_area_ = cellArea * numFreeCells;
+    int dimensions = 2;
+    double vUnitBall = M_PI;
+    ball_radius_constant_ = 2.0 * std::pow(1.0 + 1.0 / dimensions, 1.0 / dimensions) *
+                            std::pow(free_area_ / vUnitBall, 1.0 / dimensions);
+}
+
+double PlannerCore::calculateBallRadius(int tree_size, int dimensions, double max_connection_distance) {
+    // r = min(gamma (log n / n)^(1/d), max_connection_distance). Once samples come from the
+    // informed ellipse, gamma takes the ellipse's measure in place of the free space's, as in
+    // Informed RRT* (Gammell et al.); otherwise a tree packed into a thin ellipse would rewire
+    // against ever more neighbors.
+    double gamma = ball_radius_constant_;
+    double informed_area = sampler_.informedArea();
+    if (informed_area < free_area_) gamma *= std::pow(informed_area / free_area_, 1.0 / dimensions);
+    double shrink = std::pow(std::log(tree_size) / tree_size, 1.0 / dimensions);
+    return std::min(gamma * shrink, max_connection_distance);
+}
+
+void PlannerCore::fitRewireCells(double ball_radius) {
+    // Cells that stay about one rewire radius wide keep each rewire query to a 3x3 block of cells
+    // holding O(log n) vertices, and re-filing keeps each cell's vertices together in memory.
+    // Both are redone only once the radius has halved or the tree has doubled, O(n) work per
+    // doubling: amortized O(1) per insert. Cells never get finer than the map.
+    const bool finer = ball_radius >= grid_.resolution && ball_radius <= 0.5 * grid_index_.cellSize();
+    if (finer || grid_index_.size() >= 2 * grid_index_.filedSize() + kMinRefiledVertices) {
+        ScopedPhase phase(phase_timer_, &statistics_.nearest_time);
+        grid_index_.rebuild(finer ? ball_radius : grid_index_.cellSize());
+    }
+}
+
+void PlannerCore::findVerticesInsideCircle(double center_x, double center_y, double radius,
+                                       std::vector<int>& vertices_inside_circle) {
+    ScopedPhase phase(phase_timer_, &statistics_.nearest_time);
+    vertices_inside_circle.clear();
+    grid_index_.query(center_x, center_y, radius, vertices_inside_circle);
+}
+
+
+double PlannerCore::calculate_distance(double x, double y, uint32_t vertex) {
+    return std::hypot(tree_.x[vertex] - x, tree_.y[vertex] - y);
+}
+
+uint32_t PlannerCore::nearest_neighbor(double x, double y) const {
+    if (static_cast<int>(tree_.size()) < nn_brute_force_threshold_) {
+        return nearestBruteForce(tree_.x.data(), tree_.y.data(), tree_.size(), x, y);
+    }
+    int index = kd_tree_.nearest(x, y);
+    return index < 0 ? Tree::kNone : static_cast<uint32_t>(index);
+}
+
+
+bool PlannerCore::connectible(double start_x, double start_y, double end_x, double end_y) {
+    ScopedPhase phase(phase_timer_, &statistics_.collision_time);
+    statistics_.edges_checked++;
+    return edgeFree(start_x, start_y, end_x, end_y, statistics_.edges_resolved_by_field, statistics_.cells_touched);
+}
+
+bool PlannerCore::edgeFree(double start_x, double start_y, double end_x, double end_y,
+                       unsigned int& resolved_by_field, std::size_t& cells_touched) const {
+    if (use_distance_field_) {
+        double start_clearance = distance_field_.clearance(start_x, start_y);
+        double end_clearance = distance_field_.clearance(end_x, end_y);
+        // An endpoint in a non-free cell or off the map can never be connected
+        if (start_clearance == 0.0 || end_clearance == 0.0) {
+            if (!segmentFree(grid_, start_x, start_y, start_x, start_y, cells_touched) ||
+                !segmentFree(grid_, end_x, end_y, end_x, end_y, cells_touched)) {
+                resolved_by_field++;
+                return false;
+            }
+        }
+        // Every point of the edge lies within the clearance disc of one of its endpoints
+        if (start_clearance + end_clearance > std::hypot(end_x - start_x, end_y - start_y)) {
+            resolved_by_field++;
+            return true;
+        }
+    }
+    return segmentFree(grid_, start_x, start_y, end_x, end_y, cells_touched);
+}
+
+double PlannerCore::calculate_cost_from_start(uint32_t vertex) {
+    return tree_.cost_to_come[vertex];
+}
+
+bool PlannerCore::reuseTree(double start_x, double start_y) {
+    // Walk the previous tree from its root and keep the vertices that are still reached over free
+    // edges and could still lie on a route cheaper than the previous solution. The old root stays
+    // as the hub the rest hangs from; a pruned vertex takes its whole subtree with it, since every
+    // route through it costs at least as much as its own bound. Blocked cells away from the old
+    // route leave its cost a valid bound; once the route itself is cut, the next one detours, and
+    // the bound widens by kReuseDetourFactor instead of being dropped, so costmap noise cannot stop
+    // pruning altogether.
+    const std::size_t old_size = tree_.size();
+    const bool route_free = change_mask_.empty() || previousRouteFree();
+    const double cost_limit = route_free ? previous_solution_cost_ : kReuseDetourFactor * previous_solution_cost_;
+    reuse_keep_.assign(old_size, 0);
+    reuse_queue_.clear();
+    reuse_orphans_.clear();
+    reuse_queue_.push_back(0);
+    reuse_keep_[0] = 1;
+
+    // A vertex cut off by a blocked edge looks for another parent among the kept vertices, as in
+    // RRTX, and keeps its subtree if it finds one; one that finds none hands the search on to its
+    // children. Either way only the subtrees below blocked edges are touched. Those subtrees are
+    // kept whole rather than pruned: their vertices are what the tree had grown beyond the cut,
+    // and the bound, taken before the repair, says least about them.
+    std::size_t next = 0, next_orphan = 0;
+    while (true) {
+        for (; next < reuse_queue_.size(); ++next) {
+            uint32_t vertex = reuse_queue_[next];
+            keepReachableChildren(vertex, start_x, start_y, reuse_keep_[vertex] == kReuseReattached ?
+                                  std::numeric_limits<double>::infinity() : cost_limit);
+        }
+        if (next_orphan == reuse_orphans_.size()) break;
+        uint32_t orphan = reuse_orphans_[next_orphan++];
+        if (reattachOrphan(orphan)) {
+            statistics_.reattached_vertices++;
+            reuse_keep_[orphan] = kReuseReattached;
+            reuse_queue_.push_back(orphan);
+            continue;
+        }
+        for (uint32_t child = tree_.first_child[orphan]; child != Tree::kNone; child = tree_.next_sibling[child]) {
+            reuse_orphans_.push_back(child);
+        }
+    }
+
+    // Once the route was cut, the cheapest route the repaired tree still has to the goal bounds the
+    // next solution far more tightly than the widened cost. A second pass in keep order, where
+    // parents precede their children, prunes to it.
+    const double repaired_cost = route_free ? cost_limit : repairedRouteCost();
+    if (repaired_cost < cost_limit) {
+        for (uint32_t vertex : reuse_queue_) {
+            if (vertex != 0 && (!reuse_keep_[tree_.parent[vertex]] ||
+                                (reuse_keep_[vertex] != kReuseReattached &&
+                                 reuseBound(vertex, start_x, start_y) > repaired_cost))) {
+                reuse_keep_[vertex] = 0;
+            }
+        }
+        reuse_queue_.erase(std::remove_if(reuse_queue_.begin(), reuse_queue_.end(),
+                                          [this](uint32_t vertex) { return !reuse_keep_[vertex]; }),
+                           reuse_queue_.end());
+    }
+
+    // Together with the new start and this plan's growth the tree stays within max_iterations
+    // vertices, so repeated replans cannot grow it, and the rebuild below, without bound
+    const std::size_t budget = static_cast<std::size_t>(max_iterations_);
+    const std::size_t growth = std::max<std::size_t>(budget / kReuseGrowthDivisor, 1);
+    const std::size_t keep_limit = budget > growth + 1 ? budget - growth - 1 : 1;
+    if (reuse_queue_.size() > keep_limit) capKeptTree(start_x, start_y, keep_limit);
+
+    // Connect the new start to the closest kept vertex it has a free edge to
+    const uint32_t attach = cheapestKeptNeighbor(start_x, start_y, true, [this, start_x, start_y](uint32_t index) {
+        return calculate_distance(start_x, start_y, index);
+    });
+    if (attach == Tree::kNone) return false;
+
+    // Re-root: the edges from the attach vertex back to the old root turn around, so the attach
+    // vertex hangs from the new start and the old root ends up a leaf-side vertex of that chain
+    reuse_parent_.assign(tree_.parent.begin(), tree_.parent.end());
+    reuse_chain_.clear();
+    uint32_t child = attach;
+    uint32_t parent = kReuseNewRoot;
+    while (child != Tree::kNone) {
+        uint32_t old_parent = tree_.parent[child];
+        reuse_parent_[child] = parent;
+        reuse_chain_.push_back(child);
+        parent = child;
+        child = old_parent;
+    }
+
+    // Rebuild the columns breadth first from the new root, so every parent precedes its children
+    // and the kept vertices are packed at the front
+    reuse_head_.assign(old_size + 1, Tree::kNone);
+    reuse_next_.assign(old_size, Tree::kNone);
+    for (uint32_t vertex = 0; vertex < old_size; ++vertex) {
+        if (!reuse_keep_[vertex]) continue;
+        uint32_t slot = reuse_parent_[vertex] == kReuseNewRoot ? old_size : reuse_parent_[vertex];
+        reuse_next_[vertex] = reuse_head_[slot];
+        reuse_head_[slot] = vertex;
+    }
+    spare_tree_.clear();
+    spare_tree_.reserve(std::max<std::size_t>(old_size + 1, max_iterations_));
+    spare_tree_.add(start_x, start_y);
+    reuse_queue_.clear();
+    reuse_remap_.assign(old_size, Tree::kNone);
+    for (uint32_t vertex = reuse_head_[old_size]; vertex != Tree::kNone; vertex = reuse_next_[vertex]) {
+        reuse_queue_.push_back(vertex);
+    }
+    for (std::size_t i = 0; i < reuse_queue_.size(); ++i) {
+        uint32_t vertex = reuse_queue_[i];
+        uint32_t new_vertex = spare_tree_.add(tree_.x[vertex], tree_.y[vertex]);
+        uint32_t new_parent = reuse_parent_[vertex] == kReuseNewRoot ? 0 : reuse_remap_[reuse_parent_[vertex]];
+        spare_tree_.reparent(new_vertex, new_parent,
+                             std::hypot(tree_.x[vertex] - spare_tree_.x[new_parent],
+                                        tree_.y[vertex] - spare_tree_.y[new_parent]));
+        reuse_remap_[vertex] = new_vertex;
+        for (uint32_t c = reuse_head_[vertex]; c != Tree::kNone; c = reuse_next_[c]) {
+            reuse_queue_.push_back(c);
+        }
+    }
+    std::swap(tree_, spare_tree_);
+
+    kd_tree_.clear();
+    kd_tree_.reserve(std::max<std::size_t>(tree_.size(), max_iterations_));
+    grid_index_.reset(grid_.origin_x, grid_.origin_y,
+                      grid_.size_x * grid_.resolution, grid_.size_y * grid_.resolution,
+                      max_connection_distance_);
+    grid_index_.reserve(std::max<std::size_t>(tree_.size(), max_iterations_));
+    for (uint32_t vertex = 0; vertex < tree_.size(); ++vertex) {
+        kd_tree_.insert(tree_.x[vertex], tree_.y[vertex], vertex);
+        grid_index_.insert(tree_.x[vertex], tree_.y[vertex], vertex);
+    }
+
+    // The chain back to the old root now runs behind the robot; let the vertices around the new
+    // root, and the branches leaving that chain (whose edges may be long), hang from it directly
+    // where that is cheaper
+    findVerticesInsideCircle(start_x, start_y, max_connection_distance_, vertices_inside_circle_);
+    for (uint32_t vertex : reuse_chain_) {
+        for (uint32_t c = tree_.first_child[reuse_remap_[vertex]]; c != Tree::kNone; c = tree_.next_sibling[c]) {
+            vertices_inside_circle_.push_back(static_cast<int>(c));
+        }
+    }
+    for (int index : vertices_inside_circle_) {
+        uint32_t vertex = index;
+        double distance = calculate_distance(start_x, start_y, vertex);
+        if (vertex != 0 && distance < calculate_cost_from_start(vertex) &&
+            connectible(start_x, start_y, tree_.x[vertex], tree_.y[vertex])) {
+            tree_.reparent(vertex, 0, distance);
+        }
+    }
+
+    // Every kept edge has now been checked, so in lazy mode each one is its own fallback
+    if (lazy_collision_checking_) {
+        edge_verified_.assign(tree_.size(), 1);
+        fallback_parent_.assign(tree_.parent.begin(), tree_.parent.end());
+    }
+
+    // Collect the goal candidates among the kept vertices; the cheapest is the starting solution
+    findVerticesInsideCircle(goal_x_, goal_y_, max_connection_distance_, vertices_inside_circle_);
+    double best_cost = std::numeric_limits<double>::infinity();
+    for (int index : vertices_inside_circle_) {
+        uint32_t vertex = index;
+        if (!connectible(tree_.x[vertex], tree_.y[vertex], goal_x_, goal_y_)) continue;
+        goal_candidates_.push_back(vertex);
+        double cost = calculate_cost_from_start(vertex) + calculate_distance(goal_x_, goal_y_, vertex);
+        if (cost < best_cost) {
+            best_cost = cost;
+            goal_vertex_ = vertex;
+        }
+    }
+    if (goal_vertex_ != Tree::kNone) {
+        statistics_.time_to_first_solution = secondsSince(plan_start_);
+        sampler_.setBestCost(best_cost);
+    }
+    return true;
+}
+
+void PlannerCore::capKeptTree(double start_x, double start_y, std::size_t limit) {
+    // Rank each vertex by the largest bound on its path from the root, which never falls from a
+    // parent to its children. The limit lowest-ranked vertices then form a subtree, and the ones
+    // dropped are those least likely to lie on the next route.
+    reuse_bounds_.resize(tree_.size());
+    reuse_ranked_.clear();
+    for (uint32_t vertex : reuse_queue_) {
+        double bound = reuseBound(vertex, start_x, start_y);
+        reuse_bounds_[vertex] = vertex == 0 ? bound : std::max(bound, reuse_bounds_[tree_.parent[vertex]]);
+        reuse_ranked_.push_back(reuse_bounds_[vertex]);
+    }
+    std::nth_element(reuse_ranked_.begin(), reuse_ranked_.begin() + (limit - 1), reuse_ranked_.end());
+    const double bound_limit = reuse_ranked_[limit - 1];
+    // A subtree shares its root's rank wherever that is the largest, so ties at the limit are common.
+    // Parents precede their children in the keep queue, so the places left go to parents first.
+    std::size_t ties = limit - std::count_if(reuse_ranked_.begin(), reuse_ranked_.begin() + (limit - 1),
+                                             [bound_limit](double rank) { return rank < bound_limit; });
+    for (uint32_t vertex : reuse_queue_) {
+        bool keep = reuse_bounds_[vertex] < bound_limit;
+        if (!keep && reuse_bounds_[vertex] == bound_limit && ties > 0) {
+            keep = true;
+            ties--;
+        }
+        reuse_keep_[vertex] = keep;
+    }
+}
+
+bool PlannerCore::previousRouteFree() {
+    // Only the edges near newly blocked cells can have been cut; lazy mode validated the whole route
+    uint32_t vertex = previous_goal_vertex_;
+    if (change_mask_.touches(tree_.x[vertex], tree_.y[vertex], previous_goal_x_, previous_goal_y_) &&
+        !connectible(tree_.x[vertex], tree_.y[vertex], previous_goal_x_, previous_goal_y_)) {
+        return false;
+    }
+    for (; vertex != 0; vertex = tree_.parent[vertex]) {
+        uint32_t parent = tree_.parent[vertex];
+        if (change_mask_.touches(tree_.x[parent], tree_.y[parent], tree_.x[vertex], tree_.y[vertex]) &&
+            !connectible(tree_.x[parent], tree_.y[parent], tree_.x[vertex], tree_.y[vertex])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double PlannerCore::repairedRouteCost() {
+    auto route_cost = [this](uint32_t index) {
+        return tree_.cost_to_come[index] + calculate_distance(goal_x_, goal_y_, index);
+    };
+    const uint32_t goal_parent = cheapestKeptNeighbor(goal_x_, goal_y_, false, route_cost);
+    return goal_parent == Tree::kNone ? std::numeric_limits<double>::infinity() : route_cost(goal_parent);
+}
+
+double PlannerCore::reuseBound(uint32_t vertex, double start_x, double start_y) {
+    return std::hypot(tree_.x[vertex] - start_x, tree_.y[vertex] - start_y) +
+           calculate_distance(goal_x_, goal_y_, vertex);
+}
+
+void PlannerCore::keepReachableChildren(uint32_t vertex, double start_x, double start_y, double cost_limit) {
+    for (uint32_t child = tree_.first_child[vertex]; child != Tree::kNone; child = tree_.next_sibling[child]) {
+        if (reuseBound(child, start_x, start_y) > cost_limit) continue;
+        // Edges away from the change are still as free as when they were added
+        bool unchecked = lazy_collision_checking_ && !edge_verified_[child];
+        if ((unchecked || change_mask_.touches(tree_.x[vertex], tree_.y[vertex], tree_.x[child], tree_.y[child])) &&
+            !connectible(tree_.x[vertex], tree_.y[vertex], tree_.x[child], tree_.y[child])) {
+            reuse_orphans_.push_back(child);
+            continue;
+        }
+        reuse_keep_[child] = reuse_keep_[vertex];
+        reuse_queue_.push_back(child);
+    }
+}
+
+bool PlannerCore::reattachOrphan(uint32_t orphan) {
+    const double x = tree_.x[orphan], y = tree_.y[orphan];
+    const uint32_t parent = cheapestKeptNeighbor(x, y, false, [this, x, y](uint32_t index) {
+        return tree_.cost_to_come[index] + calculate_distance(x, y, index);
+    });
+    if (parent == Tree::kNone) return false;
+    tree_.reparent(orphan, parent, calculate_distance(x, y, parent));
+    return true;
+}
+
+template <typename CostFunction>
+uint32_t PlannerCore::cheapestKeptNeighbor(double x, double y, bool point_is_parent, CostFunction cost) {
+    // Cheapest first, so the first free edge gives the answer and the rest go unchecked
+    findVerticesInsideCircle(x, y, max_connection_distance_, vertices_inside_circle_);
+    parent_order_.clear();
+    for (std::size_t j = 0; j < vertices_inside_circle_.size(); ++j) {
+        uint32_t index = vertices_inside_circle_[j];
+        if (reuse_keep_[index]) {
+            parent_order_.emplace_back(cost(index), j);
+        }
+    }
+    std::sort(parent_order_.begin(), parent_order_.end());
+    for (const auto& entry : parent_order_) {
+        uint32_t index = vertices_inside_circle_[entry.second];
+        if (point_is_parent ? connectible(x, y, tree_.x[index], tree_.y[index]) :
+                              connectible(tree_.x[index], tree_.y[index], x, y)) {
+            return index;
+        }
+    }
+    return Tree::kNone;
+}
+
+void PlannerCore::growTree(std::size_t target_size) {
+    // Either grow to target_size vertices, with rejected samples bounded so a blocked map cannot
+    // spin forever, or in anytime mode keep growing until the wall-clock budget is spent
+    const bool anytime = max_planning_time_ > 0.0;
+    const unsigned int max_samples = static_cast<unsigned int>(std::min<std::size_t>(
+        kMaxSamplesPerIteration * target_size, std::numeric_limits<unsigned int>::max()));
+
+    while (true) {
+        if (anytime) {
+            if ((statistics_.samples & 0xF) == 0 && std::chrono::steady_clock::now() >= deadline_) break;
+        } else if (tree_.size() + goal_tree_.size() >= target_size || statistics_.samples >= max_samples) {
+            break;
+        }
+        statistics_.samples++;
+
+        // Generate a random point, from the informed ellipse once a solution is known
+        double rand_x, rand_y;
+        uint32_t nearest;
+        {
+            ScopedPhase phase(phase_timer_, &statistics_.sampling_time);
+            sampler_.sample(random_engine_, statistics_.samples, rand_x, rand_y);
+            phase_timer_.enter(&statistics_.nearest_time);
+            nearest = nearest_neighbor(rand_x, rand_y);
+        }
+
+        bool rewired = false;
+        uint32_t new_vertex = extend(rand_x, rand_y, nearest, rewired);
+        if (new_vertex == Tree::kNone) statistics_.samples_rejected++;
+        if (!bidirectional_) {
+            if (new_vertex != Tree::kNone) trackGoal(new_vertex, rewired);
+            continue;
+        }
+
+        // Pull the other tree toward the new vertex; either way it takes the next sample
+        swapTrees();
+        if (new_vertex != Tree::kNone) {
+            uint32_t reached = connectTrees(rand_x, rand_y, rewired);
+            trackBridge(reached, new_vertex, rewired);
+        }
+    }
+    if (trees_swapped_) swapTrees();
+}
+
+uint32_t PlannerCore::extend(double x, double y, uint32_t nearest, bool& rewired) {
+    // The new vertex is only added once the edge to its nearest neighbor is known to be free
+    if (!connectible(tree_.x[nearest], tree_.y[nearest], x, y)) return Tree::kNone;
+
+    // Perform rewire operation
+    double ball_radius = calculateBallRadius(tree_.size(), 2, max_connection_distance_);
+    fitRewireCells(ball_radius);
+
+    // Lazy mode takes the edges to the rewire neighbors as free until they land on a route to the goal
+    findVerticesInsideCircle(x, y, ball_radius, vertices_inside_circle_);
+    edge_states_.assign(vertices_inside_circle_.size(), lazy_collision_checking_ ? kEdgeFree : kEdgeUnknown);
+    return insertVertex(x, y, nearest, rewired);
+}
+
+bool PlannerCore::neighborEdgeFree(std::size_t j, double x, double y) {
+    if (edge_states_[j] == kEdgeUnknown) {
+        uint32_t index = vertices_inside_circle_[j];
+        edge_states_[j] = connectible(x, y, tree_.x[index], tree_.y[index]) ? kEdgeFree : kEdgeBlocked;
+    }
+    return edge_states_[j] == kEdgeFree;
+}
+
+uint32_t PlannerCore::insertVertex(double x, double y, uint32_t nearest, bool& rewired) {
+    ScopedPhase phase(phase_timer_, &statistics_.rewire_time);
+    uint32_t new_vertex = tree_.add(x, y);
+    tree_.reparent(new_vertex, nearest, calculate_distance(x, y, nearest));
+    kd_tree_.insert(x, y, new_vertex);
+    grid_index_.insert(x, y, new_vertex);
+    if (lazy_collision_checking_) {
+        // The edge to the nearest vertex was checked, and stays the fallback if a cheaper one fails
+        edge_verified_.push_back(1);
+        fallback_parent_.push_back(nearest);
+    }
+
+    // Choose the parent: try the neighbors in order of the cost through them and stop at the first
+    // free edge, since none of the remaining ones could beat it
+    double total_cost_for_new_position = calculate_cost_from_start(new_vertex);
+    sortByPotentialCost(x, y, total_cost_for_new_position, vertices_inside_circle_, parent_order_);
+    for (const auto& entry : parent_order_) {
+        if (neighborEdgeFree(entry.second, x, y)) {
+            uint32_t index = vertices_inside_circle_[entry.second];
+            tree_.reparent(new_vertex, index, calculate_distance(x, y, index));
+            if (lazy_collision_checking_) {
+                edge_verified_[new_vertex] = 0;
+            }
+            total_cost_for_new_position = entry.first;
+            break;
+        }
+    }
+
+    // Rewire: every neighbor that would get cheaper through the new vertex needs its edge checked,
+    // so the unknown ones go out as one batch
+    rewire_edges_.clear();
+    rewire_slots_.clear();
+    for (size_t j = 0; j < vertices_inside_circle_.size(); ++j) {
+        uint32_t index = vertices_inside_circle_[j];
+        if (index == tree_.parent[new_vertex] || edge_states_[j] != kEdgeUnknown) continue;
+        if (total_cost_for_new_position + calculate_distance(x, y, index) < calculate_cost_from_start(index)) {
+            rewire_edges_.push_back(Edge{x, y, tree_.x[index], tree_.y[index]});
+            rewire_slots_.push_back(j);
+        }
+    }
+    checkEdges(rewire_edges_.data(), rewire_edges_.size(), rewire_free_mask_);
+    for (size_t k = 0; k < rewire_slots_.size(); ++k) {
+        edge_states_[rewire_slots_[k]] = (rewire_free_mask_[k >> 6] >> (k & 63)) & 1 ? kEdgeFree : kEdgeBlocked;
+    }
+
+    // Route the neighbors through the new vertex. An earlier rewire can lower a later neighbor's cost,
+    // so the test is repeated. Ancestors of the new vertex can never pass it, so this cannot create a cycle.
+    for (size_t j = 0; j < vertices_inside_circle_.size(); ++j) {
+        uint32_t index = vertices_inside_circle_[j];
+        if (index == tree_.parent[new_vertex] || edge_states_[j] != kEdgeFree) continue;
+        double distance = calculate_distance(x, y, index);
+        if (total_cost_for_new_position + distance < calculate_cost_from_start(index)) {
+            tree_.reparent(index, new_vertex, distance);
+            if (lazy_collision_checking_) {
+                edge_verified_[index] = 0;
+            }
+            rewired = true;
+        }
+    }
+    return new_vertex;
+}
+
+void PlannerCore::sortByPotentialCost(double x, double y, double cost_bound, const std::vector<int>& neighbors,
+                                  std::vector<std::pair<double, std::size_t>>& order) const {
+    order.clear();
+    for (std::size_t j = 0; j < neighbors.size(); ++j) {
+        uint32_t index = neighbors[j];
+        double potential_cost = tree_.cost_to_come[index] + std::hypot(tree_.x[index] - x, tree_.y[index] - y);
+        if (potential_cost < cost_bound) {
+            order.emplace_back(potential_cost, j);
+        }
+    }
+    std::sort(order.begin(), order.end());
+}
+
+void PlannerCore::checkEdges(const Edge* edges, std::size_t count, std::vector<uint64_t>& free_mask) {
+    free_mask.assign((count + 63) / 64, 0);
+    statistics_.edges_checked += count;
+    if (count < kMinParallelEdges || worker_pool_->size() == 1) {
+        ScopedPhase phase(phase_timer_, &statistics_.collision_time);
+        for (std::size_t i = 0; i < count; ++i) {
+            const Edge& e = edges[i];
+            if (edgeFree(e.x0, e.y0, e.x1, e.y1, statistics_.edges_resolved_by_field, statistics_.cells_touched)) {
+                free_mask[i >> 6] |= uint64_t{1} << (i & 63);
+            }
+        }
+        return;
+    }
+
+    // Each task fills one byte of results, so no two workers ever write the same mask word. Workers
+    // time their own checks; the planning thread's wait is charged to no phase.
+    const std::size_t chunks = (count + 7) / 8;
+    chunk_bits_.assign(chunks, 0);
+    worker_resolved_by_field_.assign(worker_pool_->size(), 0);
+    worker_cells_touched_.assign(worker_pool_->size(), 0);
+    worker_collision_time_.assign(worker_pool_->size(), 0.0);
+    ScopedPhase wait(phase_timer_, nullptr);
+    // The task captures two words, which std::function stores without allocating
+    const std::pair<const Edge*, std::size_t> batch(edges, count);
+    worker_pool_->run(chunks, [this, &batch](std::size_t chunk, std::size_t worker) {
+        PhaseTimer timer;
+        timer.start(time_phases_);
+        ScopedPhase phase(timer, &worker_collision_time_[worker]);
+        uint8_t bits = 0;
+        for (std::size_t i = chunk * 8; i < std::min(batch.second, chunk * 8 + 8); ++i) {
+            const Edge& e = batch.first[i];
+            if (edgeFree(e.x0, e.y0, e.x1, e.y1, worker_resolved_by_field_[worker], worker_cells_touched_[worker])) {
+                bits |= static_cast<uint8_t>(1u << (i & 7));
+            }
+        }
+        chunk_bits_[chunk] = bits;
+    });
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        free_mask[chunk >> 3] |= uint64_t{chunk_bits_[chunk]} << ((chunk & 7) * 8);
+    }
+    for (std::size_t worker = 0; worker < worker_pool_->size(); ++worker) {
+        statistics_.edges_resolved_by_field += worker_resolved_by_field_[worker];
+        statistics_.cells_touched += worker_cells_touched_[worker];
+        statistics_.collision_time += worker_collision_time_[worker];
+    }
+}
+
+void PlannerCore::growTreeParallel(std::size_t target_size) {
+    // Samples are drawn in order on this thread, then their nearest lookups, neighbor queries and
+    // edge checks run on the pool against the tree as it stood at the start of the batch. Vertices
+    // are inserted and rewired serially in sample order, so a batch's samples do not see each other;
+    // an edge the workers did not check but the insertion needs is checked at insertion time.
+    const bool anytime = max_planning_time_ > 0.0;
+    const unsigned int max_samples = static_cast<unsigned int>(std::min<std::size_t>(
+        kMaxSamplesPerIteration * target_size, std::numeric_limits<unsigned int>::max()));
+    const std::size_t batch_size = deterministic_ ? kDeterministicBatchSize :
+        kParallelBatchPerThread * worker_pool_->size();
+    batch_.resize(batch_size);
+
+    while (true) {
+        if (anytime) {
+            if (std::chrono::steady_clock::now() >= deadline_) break;
+        } else if (tree_.size() >= target_size || statistics_.samples >= max_samples) {
+            break;
+        }
+
+        std::size_t count = anytime ? batch_size : std::min<std::size_t>(batch_size, max_samples - statistics_.samples);
+        {
+            ScopedPhase phase(phase_timer_, &statistics_.sampling_time);
+            for (std::size_t i = 0; i < count; ++i) {
+                statistics_.samples++;
+                sampler_.sample(random_engine_, statistics_.samples, batch_[i].x, batch_[i].y);
+            }
+        }
+
+        // Candidates time their own preparation; the planning thread's wait is charged to no phase
+        const double ball_radius = calculateBallRadius(tree_.size(), 2, max_connection_distance_);
+        fitRewireCells(ball_radius);
+        {
+            ScopedPhase wait(phase_timer_, nullptr);
+            worker_pool_->run(count, [this, ball_radius](std::size_t i, std::size_t) {
+                prepareCandidate(batch_[i], ball_radius);
+            });
+        }
+
+        for (std::size_t i = 0; i < count && (anytime || tree_.size() < target_size); ++i) {
+            Candidate& candidate = batch_[i];
+            statistics_.edges_checked += candidate.edges_checked;
+            statistics_.edges_resolved_by_field += candidate.edges_resolved_by_field;
+            statistics_.cells_touched += candidate.cells_touched;
+            statistics_.nearest_time += candidate.nearest_time;
+            statistics_.collision_time += candidate.collision_time;
+            statistics_.rewire_time += candidate.rewire_time;
+            if (candidate.nearest == Tree::kNone) {
+                statistics_.samples_rejected++;
+                continue;
+            }
+
+            // Copied rather than swapped, so every buffer keeps the capacity it grew to across plans
+            vertices_inside_circle_.assign(candidate.neighbors.begin(), candidate.neighbors.end());
+            edge_states_.assign(candidate.edge_states.begin(), candidate.edge_states.end());
+            bool rewired = false;
+            uint32_t new_vertex = insertVertex(candidate.x, candidate.y, candidate.nearest, rewired);
+            trackGoal(new_vertex, rewired);
+        }
+    }
+}
+
+void PlannerCore::prepareCandidate(Candidate& candidate, double ball_radius) const {
+    candidate.edges_checked = 0;
+    candidate.edges_resolved_by_field = 0;
+    candidate.cells_touched = 0;
+    candidate.nearest_time = candidate.collision_time = candidate.rewire_time = 0.0;
+    candidate.neighbors.clear();
+    candidate.edge_states.clear();
+    PhaseTimer timer;
+    timer.start(time_phases_);
+
+    const double x = candidate.x;
+    const double y = candidate.y;
+    timer.enter(&candidate.nearest_time);
+    uint32_t nearest = nearest_neighbor(x, y);
+    timer.enter(&candidate.collision_time);
+    candidate.edges_checked++;
+    if (!edgeFree(tree_.x[nearest], tree_.y[nearest], x, y, candidate.edges_resolved_by_field,
+                  candidate.cells_touched)) {
+        timer.stop();
+        candidate.nearest = Tree::kNone;
+        return;
+    }
+    candidate.nearest = nearest;
+
+    // Check the edges the insertion is expected to need: the parent choice, in order of the cost
+    // through each neighbor up to the first free edge, and the rewires that choice makes worthwhile
+    timer.enter(&candidate.nearest_time);
+    grid_index_.query(x, y, ball_radius, candidate.neighbors);
+    timer.enter(&candidate.rewire_time);
+    candidate.edge_states.assign(candidate.neighbors.size(), kEdgeUnknown);
+    double new_cost = tree_.cost_to_come[nearest] + std::hypot(tree_.x[nearest] - x, tree_.y[nearest] - y);
+    sortByPotentialCost(x, y, new_cost, candidate.neighbors, candidate.order);
+    timer.enter(&candidate.collision_time);
+    for (const auto& entry : candidate.order) {
+        uint32_t index = candidate.neighbors[entry.second];
+        candidate.edges_checked++;
+        bool free = edgeFree(x, y, tree_.x[index], tree_.y[index], candidate.edges_resolved_by_field,
+                             candidate.cells_touched);
+        candidate.edge_states[entry.second] = free ? kEdgeFree : kEdgeBlocked;
+        if (free) {
+            new_cost = entry.first;
+            break;
+        }
+    }
+    for (std::size_t j = 0; j < candidate.neighbors.size(); ++j) {
+        uint32_t index = candidate.neighbors[j];
+        if (candidate.edge_states[j] != kEdgeUnknown) continue;
+        if (new_cost + std::hypot(tree_.x[index] - x, tree_.y[index] - y) < tree_.cost_to_come[index]) {
+            candidate.edges_checked++;
+            bool free = edgeFree(x, y, tree_.x[index], tree_.y[index], candidate.edges_resolved_by_field,
+                                 candidate.cells_touched);
+            candidate.edge_states[j] = free ? kEdgeFree : kEdgeBlocked;
+        }
+    }
+    timer.stop();
+}
+
+uint32_t PlannerCore::connectTrees(double target_x, double target_y, bool& rewired) {
+    // RRT-Connect: step toward the target at most max_connection_distance_ at a time, until it is
+    // reached or the next step is blocked
+    ScopedPhase phase(phase_timer_, &statistics_.goal_connection_time);
+    while (true) {
+        uint32_t nearest;
+        {
+            ScopedPhase lookup(phase_timer_, &statistics_.nearest_time);
+            nearest = nearest_neighbor(target_x, target_y);
+        }
+        double distance = calculate_distance(target_x, target_y, nearest);
+        double x = target_x;
+        double y = target_y;
+        bool reaches = distance <= max_connection_distance_;
+        if (!reaches) {
+            double step = max_connection_distance_ / distance;
+            x = tree_.x[nearest] + step * (target_x - tree_.x[nearest]);
+            y = tree_.y[nearest] + step * (target_y - tree_.y[nearest]);
+        }
+        uint32_t vertex = extend(x, y, nearest, rewired);
+        if (vertex == Tree::kNone || reaches) return vertex;
+    }
+}
+
+void PlannerCore::swapTrees() {
+    std::swap(tree_, goal_tree_);
+    std::swap(kd_tree_, goal_kd_tree_);
+    std::swap(grid_index_, goal_grid_index_);
+    trees_swapped_ = !trees_swapped_;
+}
+
+void PlannerCore::trackGoal(uint32_t new_vertex, bool rewired) {
+    ScopedPhase phase(phase_timer_, &statistics_.goal_connection_time);
+    // Every vertex within connection range of the goal and with a free edge to it is a candidate
+    double goal_distance = calculate_distance(goal_x_, goal_y_, new_vertex);
+    bool candidate = goal_distance <= max_connection_distance_ &&
+                     connectible(tree_.x[new_vertex], tree_.y[new_vertex], goal_x_, goal_y_);
+    if (candidate) {
+        goal_candidates_.push_back(new_vertex);
+    }
+
+    double best_cost = sampler_.bestCost();
+    uint32_t best_vertex = goal_vertex_;
+    if (rewired && !goal_candidates_.empty()) {
+        // Rewiring may have lowered the cost of any earlier candidate, the current best included
+        best_cost = std::numeric_limits<double>::infinity();
+        for (uint32_t vertex : goal_candidates_) {
+            double cost = calculate_cost_from_start(vertex) + calculate_distance(goal_x_, goal_y_, vertex);
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_vertex = vertex;
+            }
+        }
+    } else if (candidate && calculate_cost_from_start(new_vertex) + goal_distance < best_cost) {
+        best_cost = calculate_cost_from_start(new_vertex) + goal_distance;
+        best_vertex = new_vertex;
+    }
+    if (best_vertex == Tree::kNone || best_cost >= sampler_.bestCost()) return;
+
+    // A lazy route is only accepted once every edge on it has been checked. The repairs can raise
+    // the cost of the current route too, so the cheapest valid one replaces it even if it is dearer.
+    if (lazy_collision_checking_ && !validatePath(best_vertex)) {
+        best_vertex = validatedGoalVertex(best_cost);
+        if (best_vertex == Tree::kNone) return;
+    }
+
+    // Tighten c_best as soon as a cheaper route to the goal exists
+    if (goal_vertex_ == Tree::kNone) {
+        statistics_.time_to_first_solution = secondsSince(plan_start_);
+    }
+    goal_vertex_ = best_vertex;
+    sampler_.setBestCost(best_cost);
+}
+
+bool PlannerCore::validatePath(uint32_t vertex) {
+    // Check the unverified edges from the vertex back to the root. The first blocked one is cut
+    // and the tree repaired around it, which leaves the route invalid.
+    uint32_t child = vertex;
+    for (; tree_.parent[child] != Tree::kNone; child = tree_.parent[child]) {
+        if (edge_verified_[child]) continue;
+        uint32_t parent = tree_.parent[child];
+        if (!connectible(tree_.x[parent], tree_.y[parent], tree_.x[child], tree_.y[child])) {
+            repairVertex(child);
+            return false;
+        }
+        edge_verified_[child] = 1;
+    }
+    // Only the root has no parent and a finite cost; anything else is a cut-off subtree
+    return child == 0;
+}
+
+void PlannerCore::repairVertex(uint32_t vertex) {
+    // Cut the vertex off at infinite cost, then re-attach it to the cheapest neighbor it has a free
+    // edge to, its checked fallback parent included. Its own subtree is at infinite cost too, so
+    // candidates inside it are never picked and no cycle can form.
+    const double x = tree_.x[vertex];
+    const double y = tree_.y[vertex];
+    const uint32_t fallback = fallback_parent_[vertex];
+    tree_.reparent(vertex, Tree::kNone, std::numeric_limits<double>::infinity());
+    statistics_.edges_repaired++;
+
+    findVerticesInsideCircle(x, y, calculateBallRadius(tree_.size(), 2, max_connection_distance_),
+                             vertices_inside_circle_);
+    if (std::find(vertices_inside_circle_.begin(), vertices_inside_circle_.end(),
+                  static_cast<int>(fallback)) == vertices_inside_circle_.end()) {
+        vertices_inside_circle_.push_back(fallback);
+    }
+    sortByPotentialCost(x, y, std::numeric_limits<double>::infinity(), vertices_inside_circle_, parent_order_);
+    for (const auto& entry : parent_order_) {
+        uint32_t index = vertices_inside_circle_[entry.second];
+        if (index == fallback || connectible(tree_.x[index], tree_.y[index], x, y)) {
+            tree_.reparent(vertex, index, calculate_distance(x, y, index));
+            edge_verified_[vertex] = 1;
+            return;
+        }
+    }
+
+    // Every candidate lies in the cut-off subtree. Fallback parents are always older vertices, so
+    // re-attaching the subtree to them oldest first reconnects all of it over checked edges.
+    repair_subtree_.clear();
+    repair_subtree_.push_back(vertex);
+    for (std::size_t i = 0; i < repair_subtree_.size(); ++i) {
+        for (uint32_t child = tree_.first_child[repair_subtree_[i]]; child != Tree::kNone;
+             child = tree_.next_sibling[child]) {
+            repair_subtree_.push_back(child);
+        }
+    }
+    std::sort(repair_subtree_.begin(), repair_subtree_.end());
+    for (uint32_t orphan : repair_subtree_) {
+        if (std::isinf(tree_.cost_to_come[orphan])) {
+            uint32_t parent = fallback_parent_[orphan];
+            tree_.reparent(orphan, parent, calculate_distance(tree_.x[parent], tree_.y[parent], orphan));
+            edge_verified_[orphan] = 1;
+        }
+    }
+}
+
+uint32_t PlannerCore::validatedGoalVertex(double& cost) {
+    // Repairs only raise costs, so keep taking the cheapest candidate until one route checks out
+    while (true) {
+        cost = std::numeric_limits<double>::infinity();
+        uint32_t best_vertex = Tree::kNone;
+        for (uint32_t vertex : goal_candidates_) {
+            double candidate_cost = calculate_cost_from_start(vertex) + calculate_distance(goal_x_, goal_y_, vertex);
+            if (candidate_cost < cost) {
+                cost = candidate_cost;
+                best_vertex = vertex;
+            }
+        }
+        if (best_vertex == Tree::kNone || validatePath(best_vertex)) return best_vertex;
+    }
+}
+
+void PlannerCore::trackBridge(uint32_t vertex, uint32_t other_vertex, bool rewired) {
+    ScopedPhase phase(phase_timer_, &statistics_.goal_connection_time);
+    // Bridges are pairs of coincident vertices, one in each tree, stored start side first
+    const Tree& start_tree = trees_swapped_ ? goal_tree_ : tree_;
+    const Tree& goal_tree = trees_swapped_ ? tree_ : goal_tree_;
+    bool bridged = vertex != Tree::kNone;
+    if (bridged) {
+        bridges_.push_back(trees_swapped_ ? std::make_pair(other_vertex, vertex) : std::make_pair(vertex, other_vertex));
+    }
+
+    double best_cost = sampler_.bestCost();
+    std::size_t best_bridge = bridges_.size();
+    if (rewired) {
+        // Rewiring on either side may have lowered the cost of any earlier bridge
+        best_cost = std::numeric_limits<double>::infinity();
+        for (std::size_t i = 0; i < bridges_.size(); ++i) {
+            double cost = start_tree.cost_to_come[bridges_[i].first] + goal_tree.cost_to_come[bridges_[i].second];
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_bridge = i;
+            }
+        }
+    } else if (bridged) {
+        double cost = start_tree.cost_to_come[bridges_.back().first] + goal_tree.cost_to_come[bridges_.back().second];
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_bridge = bridges_.size() - 1;
+        }
+    }
+    if (best_bridge == bridges_.size() || best_cost >= sampler_.bestCost()) return;
+
+    if (goal_vertex_ == Tree::kNone) {
+        statistics_.time_to_first_solution = secondsSince(plan_start_);
+    }
+    goal_vertex_ = bridges_[best_bridge].first;
+    goal_tree_vertex_ = bridges_[best_bridge].second;
+    sampler_.setBestCost(best_cost);
+}
+
+uint32_t PlannerCore::connectGoal() {
+    // Widen the search ring by ring: candidates already tried at a smaller radius are skipped,
+    // and the first ring that yields a free edge decides the goal's parent
+    const double max_radius = kGoalConnectionMaxRadiusFactor * max_connection_distance_;
+    double inner_radius = 0.0;
+    // The ball radius of a single-vertex tree is zero, which doubling would never widen
+    double radius = std::min(std::max(2 * calculateBallRadius(tree_.size(), 2, max_connection_distance_),
+                                      grid_.resolution), max_radius);
+    while (true) {
+        findVerticesInsideCircle(goal_x_, goal_y_, radius, vertices_inside_circle_);
+
+        double min_cost = std::numeric_limits<double>::infinity();
+        uint32_t goal_parent = Tree::kNone;
+        for (size_t j = 0; j < vertices_inside_circle_.size(); ++j) {
+            uint32_t index = vertices_inside_circle_[j];
+            double distance = calculate_distance(goal_x_, goal_y_, index);
+            if (inner_radius > 0.0 && distance <= inner_radius) continue;
+            double potential_cost = calculate_cost_from_start(index) + distance;
+            if (potential_cost < min_cost && connectible(goal_x_, goal_y_, tree_.x[index], tree_.y[index])) {
+                goal_parent = index;
+                min_cost = potential_cost;
+            }
+        }
+
+        if (goal_parent != Tree::kNone || radius >= max_radius) {
+            return goal_parent;
+        }
+        inner_radius = radius;
+        radius = std::min(2 * radius, max_radius);
+    }
+}
+
+void PlannerCore::extractRoute(uint32_t goal_parent, uint32_t goal_tree_vertex,
+                               std::vector<std::pair<double, double>>& route) {
+    route.clear();
+    for (uint32_t vertex = goal_parent; vertex != Tree::kNone; vertex = tree_.parent[vertex]) {
+        route.emplace_back(tree_.x[vertex], tree_.y[vertex]);
+    }
+    std::reverse(route.begin(), route.end());
+    if (goal_tree_vertex == Tree::kNone) {
+        route.emplace_back(goal_x_, goal_y_);
+    } else {
+        for (uint32_t vertex = goal_tree_.parent[goal_tree_vertex]; vertex != Tree::kNone;
+             vertex = goal_tree_.parent[vertex]) {
+            route.emplace_back(goal_tree_.x[vertex], goal_tree_.y[vertex]);
+        }
+    }
+}
+
+}  // namespace nav2_rrtstar_planner
@@ -1,12 +1,13 @@
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <memory>
 #include "nav2_util/node_utils.hpp"
-#include <random>
+#include "nav2_core/exceptions.hpp"
 #include <vector>
-#include <limits>
 #include <Eigen/Dense>
 #include <unsupported/Eigen/Splines>  // Eigen库的B样条相关支持
+#include "nav2_rrtstar_planner/nearest_kernel.hpp"
 #include "nav2_rrtstar_planner/rrtstar_planner.hpp"
 
 namespace nav2_rrtstar_planner
@@ -25,13 +26,98 @@ void RRTStar::configure(
   name_ = name;
   tf_ = tf;
   costmap_ = costmap_ros->getCostmap();
+  grid_map_ = std::make_unique<CostmapGridMap>(costmap_);
   global_frame_ = costmap_ros->getGlobalFrameID();
-  max_iterations_ = 1000;
+  PlannerConfig config;
 
   // Parameter initialization
   nav2_util::declare_parameter_if_not_declared(
-    node_, name_ + ".interpolation_resolution", rclcpp::ParameterValue(0.01));
-  node_->get_parameter(name_ + ".interpolation_resolution", interpolation_resolution_);
+    node_, name_ + ".max_iterations", rclcpp::ParameterValue(1000));
+  node_->get_parameter(name_ + ".max_iterations", config.max_iterations);
+  if (config.max_iterations < 1) {
+    RCLCPP_WARN(
+      node_->get_logger(), "RRTStar: max_iterations must be at least 1, got %d; using 1",
+      config.max_iterations);
+    config.max_iterations = 1;
+  }
+
+  // A positive budget switches to anytime planning: the tree keeps growing until the deadline
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".max_planning_time", rclcpp::ParameterValue(0.0));
+  node_->get_parameter(name_ + ".max_planning_time", config.max_planning_time);
+  if (!(config.max_planning_time >= 0.0)) {
+    RCLCPP_WARN(
+      node_->get_logger(), "RRTStar: max_planning_time must not be negative, got %f; "
+      "planning with max_iterations only", config.max_planning_time);
+    config.max_planning_time = 0.0;
+  }
+
+  // Trees smaller than this answer nearest queries with the SIMD scan instead of the k-d tree
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".nn_brute_force_threshold", rclcpp::ParameterValue(128));
+  node_->get_parameter(name_ + ".nn_brute_force_threshold", config.nn_brute_force_threshold);
+  RCLCPP_DEBUG(
+    node_->get_logger(), "RRTStar nearest-neighbor scan kernel: %s", nearestKernelName());
+
+  // Resolve edges from obstacle clearance before falling back to a grid traversal
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".use_distance_field", rclcpp::ParameterValue(true));
+  node_->get_parameter(name_ + ".use_distance_field", config.use_distance_field);
+
+  // Grow a second tree from the goal and connect the two RRT-Connect style
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".bidirectional", rclcpp::ParameterValue(false));
+  node_->get_parameter(name_ + ".bidirectional", config.bidirectional);
+
+  // Threads sharing the nearest lookups and edge checks of tree growth; 1 keeps it serial
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".num_threads", rclcpp::ParameterValue(1));
+  node_->get_parameter(name_ + ".num_threads", config.num_threads);
+  if (config.num_threads > 1 && config.bidirectional) {
+    RCLCPP_WARN(
+      node_->get_logger(), "RRTStar: bidirectional planning grows its trees on one thread; "
+      "num_threads only spreads its rewire checks");
+  }
+
+  // Defer rewire edge checks until an edge lies on a route to the goal (single-tree growth only)
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".lazy_collision_checking", rclcpp::ParameterValue(false));
+  node_->get_parameter(name_ + ".lazy_collision_checking", config.lazy_collision_checking);
+  if (config.lazy_collision_checking && config.bidirectional) {
+    RCLCPP_WARN(node_->get_logger(), "RRTStar: lazy_collision_checking is ignored in bidirectional mode");
+    config.lazy_collision_checking = false;
+  } else if (config.lazy_collision_checking && config.num_threads > 1) {
+    RCLCPP_WARN(node_->get_logger(), "RRTStar: lazy collision checking grows the tree on one thread");
+  }
+
+  // Continue from the previous tree when replanning toward the same goal (single-tree growth only)
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".reuse_tree", rclcpp::ParameterValue(false));
+  node_->get_parameter(name_ + ".reuse_tree", config.reuse_tree);
+
+  // Seed every plan with seed and make the route independent of timing and num_threads
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".deterministic", rclcpp::ParameterValue(false));
+  node_->get_parameter(name_ + ".deterministic", config.deterministic);
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".seed", rclcpp::ParameterValue(0));
+  int seed = 0;
+  node_->get_parameter(name_ + ".seed", seed);
+  config.seed = static_cast<uint32_t>(seed);
+  if (config.deterministic && config.max_planning_time > 0.0) {
+    RCLCPP_WARN(node_->get_logger(), "RRTStar: max_planning_time is ignored in deterministic mode");
+  }
+
+  // Time every planning phase and publish the figures of each plan on <name>/plan_statistics
+  nav2_util::declare_parameter_if_not_declared(
+    node_, name_ + ".publish_statistics", rclcpp::ParameterValue(false));
+  node_->get_parameter(name_ + ".publish_statistics", publish_statistics_);
+  config.time_phases = publish_statistics_;
+  if (publish_statistics_) {
+    statistics_pub_ = node_->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+      name_ + "/plan_statistics", 1);
+  }
+  core_.configure(config);
 }
 
 void RRTStar::cleanup()
@@ -39,6 +125,7 @@ void RRTStar::cleanup()
   RCLCPP_INFO(
     node_->get_logger(), "CleaningUp plugin %s of type NavfnPlanner",
     name_.c_str());
+  statistics_pub_.reset();
 }
 
 void RRTStar::activate()
@@ -46,6 +133,9 @@ void RRTStar::activate()
   RCLCPP_INFO(
     node_->get_logger(), "Activating plugin %s of type NavfnPlanner",
     name_.c_str());
+  if (statistics_pub_) {
+    statistics_pub_->on_activate();
+  }
 }
 
 void RRTStar::deactivate()
@@ -53,103 +143,9 @@ void RRTStar::deactivate()
   RCLCPP_INFO(
     node_->get_logger(), "Deactivating plugin %s of type NavfnPlanner",
     name_.c_str());
-}
-
-void RRTStar::calculateBallRadiusConstant() {
-    double resolution = costmap_->getResolution();
-    double cellArea = resolution * resolution;
-    unsigned int numFreeCells = 0;
-
-    for (unsigned int x = 0; x < costmap_->getSizeInCellsX(); x++) {
-        for (unsigned int y = 0; y < costmap_->getSizeInCellsY(); y++) {
-            if (costmap_->getCost(x, y) == nav2_costmap_2d::FREE_SPACE) {
-                numFreeCells++;
-            }
-        }
-    }
-
-    double freeVolume = cellArea * numFreeCells;
-    int dimensions = 2;
-    double vUnitBall = M_PI;
-    ball_radius_constant_ = 2.0 * (1 + 1.0 / dimensions) * std::pow((freeVolume / vUnitBall), (1.0 / dimensions));
-    
-    // 在 Informed RRT* 中，我们根据目标位置调整球半径的计算
-    double goal_area_radius = 10.0; // 假设目标区域的半径为4米
-    double ball_radius_factor = std::min(goal_area_radius, ball_radius_constant_);
-    ball_radius_constant_ = ball_radius_factor;
-}
-
-double RRTStar::calculateBallRadius(int tree_size, int dimensions, double max_connection_distance) {
-    double term1 = (ball_radius_constant_ * std::log(tree_size)) / tree_size;
-    double term2 = std::pow(term1, 1.0 / dimensions);
-    return std::min(term2, max_connection_distance);
-}
-
-std::vector<int> RRTStar::findVerticesInsideCircle(double center_x, double center_y, double radius) {
-    std::vector<int> vertices_inside_circle;
-    double radius_squared = radius * radius;
-
-    for (int i = 0; i < tree_.size(); ++i) {
-        // Dereference unique_ptr to access x and y
-        double distance_squared = std::pow((*tree_[i]).x - center_x, 2) + std::pow((*tree_[i]).y - center_y, 2);
-        if (distance_squared <= radius_squared) {
-            vertices_inside_circle.push_back(i);
-        }
-    }
-    return vertices_inside_circle;
-}
-
-
-double RRTStar::calculate_distance(double x, double y, const Vertex& vertex) {
-    return std::sqrt(std::pow(vertex.x - x, 2) + std::pow(vertex.y - y, 2));
-}
-
-Vertex* RRTStar::nearest_neighbor(double x, double y) {
-    Vertex* nearest_vertex = nullptr;
-    double min_dist = std::numeric_limits<double>::infinity();
-
-    for (const auto& vertex : tree_) {
-        // Dereference unique_ptr to pass Vertex reference to calculate_distance
-        double dist = calculate_distance(x, y, *vertex);
-        if (dist < min_dist) {
-            min_dist = dist;
-            nearest_vertex = vertex.get();  // Set to raw pointer of the unique_ptr
-        }
-    }
-    return nearest_vertex;
-}
-
-
-bool RRTStar::connectible(const Vertex& start, const Vertex& end) {
-    double resolution = interpolation_resolution_;
-    double steps = std::ceil(std::hypot(end.x - start.x, end.y - start.y) / resolution);
-    if (steps > 0){
-      double x_increment = (end.x - start.x) / steps;
-      double y_increment = (end.y - start.y) / steps;
-
-      double x = start.x, y = start.y;
-      for (int i = 0; i < steps; ++i) {
-          unsigned int mx, my;
-          if (!costmap_->worldToMap(x, y, mx, my)) return false;
-          if (costmap_->getCost(mx, my) != nav2_costmap_2d::FREE_SPACE) return false;
-          x += x_increment;
-          y += y_increment;
-      }
-    }
-    return true;
-}
-
-double RRTStar::calculate_cost_from_start(const Vertex& vertex) {
-    double total_cost = 0.0;
-
-    const Vertex* cur_ver = &vertex;
-
-    while (cur_ver != nullptr) {
-        total_cost += cur_ver->cost;
-        cur_ver = cur_ver->parent;
-    }
-
-    return total_cost;
+  if (statistics_pub_) {
+    statistics_pub_->on_deactivate();
+  }
 }
 
 nav_msgs::msg::Path RRTStar::createPlan(
@@ -173,123 +169,129 @@ nav_msgs::msg::Path RRTStar::createPlan(
     global_path.header.stamp = node_->now();
     global_path.header.frame_id = global_frame_;
 
-    // Set up a random position generator
-    calculateBallRadiusConstant();
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> x_dis(costmap_->getOriginX(), costmap_->getOriginX() + costmap_->getSizeInCellsX() * costmap_->getResolution());
-    std::uniform_real_distribution<> y_dis(costmap_->getOriginY(), costmap_->getOriginY() + costmap_->getSizeInCellsY() * costmap_->getResolution());
-
-    // Add start position to the tree
-    tree_.clear();
-    tree_.reserve(max_iterations_);
-    auto start_vertex = std::make_unique<Vertex>(start.pose.position.x, start.pose.position.y);
-    start_vertex->cost = 0;
-    tree_.emplace_back(std::move(start_vertex));
-
-    // Create vertex for the end point
-    Vertex end_vertex(goal.pose.position.x, goal.pose.position.y);
-
-    geometry_msgs::msg::PoseStamped pose;
-    pose.pose.position.x = goal.pose.position.x;
-    pose.pose.position.y = goal.pose.position.y;
-    pose.pose.position.z = 0.0;
-    pose.pose.orientation = goal.pose.orientation;
-    global_path.poses.insert(global_path.poses.begin(), pose);
-
-    // 在目标附近更多采样
-    std::uniform_real_distribution<> goal_x_dis(goal.pose.position.x - 5.0, goal.pose.position.x + 5.0);
-    std::uniform_real_distribution<> goal_y_dis(goal.pose.position.y - 5.0, goal.pose.position.y + 5.0);
-
-    for (int i = 1; i <= max_iterations_ - 1; ++i) {
-        // Generate a random point
-        double rand_x = (i % 5 == 0) ? goal_x_dis(gen) : x_dis(gen);  // 在目标附近采样
-        double rand_y = (i % 5 == 0) ? goal_y_dis(gen) : y_dis(gen);
-
-        auto new_position = std::make_unique<Vertex>(rand_x, rand_y);
-
-        // Find nearest neighbor and assign its parent to new_position
-        Vertex* nearest = nearest_neighbor(rand_x, rand_y);
-        new_position->parent = nearest;  // Use raw pointer to nearest vertex
-        new_position->cost = calculate_distance(nearest->x, nearest->y, *new_position);
-
-        if (connectible(*nearest, *new_position)) {
-            // Perform rewire operation
-            double ball_radius = calculateBallRadius(tree_.size(), 2, 2.0);
-
-            std::vector<int> vertices_inside_circle = findVerticesInsideCircle(new_position->x, new_position->y, ball_radius);
-            tree_.emplace_back(std::move(new_position));
-
-            // Rewiring process, now considering better paths from start
-            double total_cost_for_new_position = calculate_cost_from_start(*tree_.back());
-            for (size_t j = 0; j < vertices_inside_circle.size(); ++j) {
-                int index = vertices_inside_circle[j];
-                double potential_cost = calculate_cost_from_start(*tree_[index]) + calculate_distance(tree_.back()->x, tree_.back()->y, *tree_[index]);
-                if (potential_cost < total_cost_for_new_position && connectible(*tree_.back(), *tree_[index])) {
-                    tree_.back()->parent = tree_[index].get();
-                    tree_.back()->cost = calculate_distance(tree_.back()->x, tree_.back()->y, *tree_[index]);
-                    total_cost_for_new_position = potential_cost;
-                }
-            }
-        } else {
-            i -= 1;
-        }
+    try {
+        core_.plan(*grid_map_, start.pose.position.x, start.pose.position.y,
+                   goal.pose.position.x, goal.pose.position.y, route_);
+    } catch (const PlanningError& e) {
+        publishStatistics(core_.statistics());
+        throw nav2_core::PlannerException(e.what());
     }
 
-    // Goal refinement and optimization process
-    double ball_radius = 2 * calculateBallRadius(tree_.size(), 2, 2.0);
-    std::vector<int> vertices_inside_circle = findVerticesInsideCircle(goal.pose.position.x, goal.pose.position.y, ball_radius);
-
-    // Look for the optimal path from the current tree to the goal
-    while (true) {
-        double min_cost = std::numeric_limits<double>::infinity();
-        for (size_t j = 0; j < vertices_inside_circle.size(); ++j) {
-            int index = vertices_inside_circle[j];
-            double potential_cost = calculate_cost_from_start(*tree_[index]) + calculate_distance(goal.pose.position.x, goal.pose.position.y, *tree_[index]);
-            if (potential_cost < min_cost && connectible(end_vertex, *tree_[index])) {
-                end_vertex.parent = tree_[index].get();
-                end_vertex.cost = calculate_distance(goal.pose.position.x, goal.pose.position.y, *tree_[index]);
-                min_cost = potential_cost;
-            }
-        }
+    // The core's figures, completed with the time spent turning its route into the path
+    PlanStatistics statistics = core_.statistics();
+    PhaseTimer timer;
+    timer.start(publish_statistics_);
+    timer.enter(&statistics.path_extraction_time);
+    extractPath(route_, goal.pose.orientation, global_path);
+    timer.enter(&statistics.smoothing_time);
+    smoothPath(global_path);
+    timer.stop();
+
+    RCLCPP_DEBUG(
+      node_->get_logger(), "Plan statistics: setup %.3f ms (costmap %s, %zu free cells), "
+      "%zu cells newly blocked, %zu vertices reused, %u reattached, %u samples (%u rejected), %zu vertices, %u edges checked, %u resolved from the distance field without a traversal, "
+      "%u repaired, %zu cells touched, "
+      "first solution after %.3f ms, final cost %.3f, total %.3f ms",
+      statistics.setup_time * 1e3, statistics.costmap_changed ? "changed" : "unchanged",
+      statistics.free_cells, statistics.blocked_cells, statistics.reused_vertices,
+      statistics.reattached_vertices, statistics.samples, statistics.samples_rejected, statistics.vertices,
+      statistics.edges_checked, statistics.edges_resolved_by_field, statistics.edges_repaired,
+      statistics.cells_touched,
+      statistics.time_to_first_solution * 1e3, statistics.solution_cost, statistics.planning_time * 1e3);
+    if (publish_statistics_) {
+        RCLCPP_DEBUG(
+          node_->get_logger(), "Plan phases: free-space scan %.3f ms, sampling %.3f ms, nearest lookups %.3f ms, "
+          "collision checks %.3f ms, rewiring %.3f ms, goal connection %.3f ms, path extraction %.3f ms, "
+          "smoothing %.3f ms",
+          statistics.scan_time * 1e3, statistics.sampling_time * 1e3, statistics.nearest_time * 1e3,
+          statistics.collision_time * 1e3, statistics.rewire_time * 1e3, statistics.goal_connection_time * 1e3,
+          statistics.path_extraction_time * 1e3, statistics.smoothing_time * 1e3);
+    }
+    publishStatistics(statistics);
+    return global_path;
+}
+
+void RRTStar::publishStatistics(const PlanStatistics& statistics) {
+    if (!statistics_pub_) return;
+
+    diagnostic_msgs::msg::DiagnosticArray message;
+    message.header.stamp = node_->now();
+    message.header.frame_id = global_frame_;
+    message.status.resize(1);
+    diagnostic_msgs::msg::DiagnosticStatus& status = message.status[0];
+    status.name = name_;
+    bool solved = statistics.solution_cost >= 0.0;
+    status.level = solved ? diagnostic_msgs::msg::DiagnosticStatus::OK : diagnostic_msgs::msg::DiagnosticStatus::WARN;
+    status.message = solved ? "path found" : "no path found";
+
+    // Times in milliseconds; the phase times are summed over the planning threads
+    auto add = [&status](const char* key, auto value) {
+        diagnostic_msgs::msg::KeyValue entry;
+        entry.key = key;
+        entry.value = std::to_string(value);
+        status.values.push_back(entry);
+    };
+    add("setup_time_ms", statistics.setup_time * 1e3);
+    add("time_to_first_solution_ms", statistics.time_to_first_solution < 0.0 ? -1.0 : statistics.time_to_first_solution * 1e3);
+    add("planning_time_ms", statistics.planning_time * 1e3);
+    add("solution_cost", statistics.solution_cost);
+    add("costmap_changed", static_cast<int>(statistics.costmap_changed));
+    add("free_cells", statistics.free_cells);
+    add("blocked_cells", statistics.blocked_cells);
+    add("reused_vertices", statistics.reused_vertices);
+    add("reattached_vertices", statistics.reattached_vertices);
+    add("samples", statistics.samples);
+    add("samples_rejected", statistics.samples_rejected);
+    add("vertices", statistics.vertices);
+    add("edges_checked", statistics.edges_checked);
+    add("edges_resolved_by_field", statistics.edges_resolved_by_field);
+    add("edges_repaired", statistics.edges_repaired);
+    add("cells_touched", statistics.cells_touched);
+    add("scan_time_ms", statistics.scan_time * 1e3);
+    add("sampling_time_ms", statistics.sampling_time * 1e3);
+    add("nearest_time_ms", statistics.nearest_time * 1e3);
+    add("collision_time_ms", statistics.collision_time * 1e3);
+    add("rewire_time_ms", statistics.rewire_time * 1e3);
+    add("goal_connection_time_ms", statistics.goal_connection_time * 1e3);
+    add("path_extraction_time_ms", statistics.path_extraction_time * 1e3);
+    add("smoothing_time_ms", statistics.smoothing_time * 1e3);
+    statistics_pub_->publish(message);
+}
 
-        if (min_cost < 10000) {
-            auto end_vertex_ptr = std::make_unique<Vertex>(end_vertex);
-            tree_.emplace_back(std::move(end_vertex_ptr));
-
-            Vertex* cur_ver = &end_vertex;
-            while (cur_ver) {
-                geometry_msgs::msg::PoseStamped pose;
-                pose.pose.position.x = cur_ver->x;
-                pose.pose.position.y = cur_ver->y;
-                pose.pose.position.z = 0.0;
-
-                global_path.poses.insert(global_path.poses.begin(), pose);
-
-                if (cur_ver->parent != nullptr) {
-                    double steps = std::ceil(std::hypot(cur_ver->x - cur_ver->parent->x, cur_ver->y - cur_ver->parent->y) * 10);
-                    double x_increment = (cur_ver->parent->x - cur_ver->x) / steps;
-                    double y_increment = (cur_ver->parent->y - cur_ver->y) / steps;
-
-                    double x = cur_ver->x;
-                    double y = cur_ver->y;
-
-                    for (int i = 0; i < steps - 1; ++i) {
-                        x += x_increment;
-                        y += y_increment;
-                        geometry_msgs::msg::PoseStamped pose;
-                        pose.pose.position.x = x;
-                        pose.pose.position.y = y;
-                        global_path.poses.insert(global_path.poses.begin(), pose);
-                    }
-                }
-                cur_ver = cur_ver->parent;
-            }
-            break;
+void RRTStar::extractPath(const std::vector<std::pair<double, double>>& route,
+                          const geometry_msgs::msg::Quaternion& goal_orientation, nav_msgs::msg::Path& path) {
+    // Each edge is densified to 10 points per meter; its end point is emitted by the next edge
+    auto edge_steps = [&route](std::size_t i) {
+        double length = std::hypot(route[i + 1].first - route[i].first,
+                                   route[i + 1].second - route[i].second);
+        return std::max(static_cast<int>(std::ceil(length * 10)), 1);
+    };
+    std::size_t count = 0;
+    for (std::size_t i = 0; i + 1 < route.size(); ++i) {
+        count += edge_steps(i);
+    }
+
+    // The goal closes the path twice, the second time carrying the requested orientation
+    const auto& goal = route.back();
+    path.poses.resize(count + 2);
+    std::size_t out = 0;
+    for (std::size_t i = 0; i + 1 < route.size(); ++i) {
+        const auto& from = route[i];
+        const auto& to = route[i + 1];
+        int steps = edge_steps(i);
+        for (int k = 0; k < steps; ++k) {
+            double t = static_cast<double>(k) / steps;
+            path.poses[out].pose.position.x = from.first + t * (to.first - from.first);
+            path.poses[out].pose.position.y = from.second + t * (to.second - from.second);
+            ++out;
         }
     }
-    smoothPath(global_path);
-    return global_path;
+    path.poses[out].pose.position.x = goal.first;
+    path.poses[out].pose.position.y = goal.second;
+    ++out;
+    path.poses[out].pose.position.x = goal.first;
+    path.poses[out].pose.position.y = goal.second;
+    path.poses[out].pose.orientation = goal_orientation;
 }
 
 void RRTStar::smoothPath(nav_msgs::msg::Path& path) {
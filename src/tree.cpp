@@ -0,0 +1,80 @@
+#include "nav2_rrtstar_planner/tree.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+constexpr uint32_t Tree::kNone;
+constexpr std::size_t Tree::kBytesPerVertex;
+
+void Tree::clear() {
+    x.clear();
+    y.clear();
+    cost.clear();
+    cost_to_come.clear();
+    parent.clear();
+    first_child.clear();
+    next_sibling.clear();
+}
+
+void Tree::reserve(std::size_t capacity) {
+    x.reserve(capacity);
+    y.reserve(capacity);
+    cost.reserve(capacity);
+    cost_to_come.reserve(capacity);
+    parent.reserve(capacity);
+    first_child.reserve(capacity);
+    next_sibling.reserve(capacity);
+}
+
+uint32_t Tree::add(double vx, double vy) {
+    x.push_back(vx);
+    y.push_back(vy);
+    cost.push_back(0.0);
+    cost_to_come.push_back(0.0);
+    parent.push_back(kNone);
+    first_child.push_back(kNone);
+    next_sibling.push_back(kNone);
+    return static_cast<uint32_t>(x.size() - 1);
+}
+
+void Tree::reparent(uint32_t vertex, uint32_t new_parent, double edge_cost) {
+    // Unlink from the old parent's child list
+    if (parent[vertex] != kNone) {
+        uint32_t* link = &first_child[parent[vertex]];
+        while (*link != kNone && *link != vertex) {
+            link = &next_sibling[*link];
+        }
+        if (*link != kNone) {
+            *link = next_sibling[vertex];
+        }
+    }
+
+    parent[vertex] = new_parent;
+    cost[vertex] = edge_cost;
+    next_sibling[vertex] = kNone;
+    cost_to_come[vertex] = edge_cost;
+    if (new_parent != kNone) {
+        next_sibling[vertex] = first_child[new_parent];
+        first_child[new_parent] = vertex;
+        cost_to_come[vertex] += cost_to_come[new_parent];
+    }
+    propagateCostToDescendants(vertex);
+}
+
+void Tree::propagateCostToDescendants(uint32_t vertex) {
+    // Stackless pre-order walk over the subtree using the child/sibling links
+    uint32_t cur = first_child[vertex];
+    while (cur != kNone) {
+        cost_to_come[cur] = cost_to_come[parent[cur]] + cost[cur];
+        if (first_child[cur] != kNone) {
+            cur = first_child[cur];
+            continue;
+        }
+        while (cur != vertex && next_sibling[cur] == kNone) {
+            cur = parent[cur];
+        }
+        cur = (cur == vertex) ? kNone : next_sibling[cur];
+    }
+}
+
+}  // namespace nav2_rrtstar_planner
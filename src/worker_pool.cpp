@@ -0,0 +1,71 @@
+#include "nav2_rrtstar_planner/worker_pool.hpp"
+
+namespace nav2_rrtstar_planner
+{
+
+WorkerPool::WorkerPool(std::size_t threads)
+: task_(nullptr), count_(0), next_(0), busy_helpers_(0), generation_(0), stopping_(false) {
+    for (std::size_t worker = 1; worker < threads; ++worker) {
+        helpers_.emplace_back(&WorkerPool::helperLoop, this, worker);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& helper : helpers_) {
+        helper.join();
+    }
+}
+
+void WorkerPool::run(std::size_t count, const std::function<void(std::size_t, std::size_t)>& task) {
+    if (count == 0) return;
+    if (helpers_.empty()) {
+        for (std::size_t i = 0; i < count; ++i) task(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        busy_helpers_ = helpers_.size();
+        ++generation_;
+    }
+    wake_.notify_all();
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_helpers_ == 0; });
+    task_ = nullptr;
+}
+
+void WorkerPool::helperLoop(std::size_t worker) {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+        }
+        drain(worker);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busy_helpers_ == 0) done_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::drain(std::size_t worker) {
+    for (std::size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < count_;
+         i = next_.fetch_add(1, std::memory_order_relaxed)) {
+        (*task_)(i, worker);
+    }
+}
+
+}  // namespace nav2_rrtstar_planner
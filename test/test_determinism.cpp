@@ -0,0 +1,73 @@
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nav2_rrtstar_planner/planner_core.hpp"
+#include "test_grid_map.hpp"
+
+using nav2_rrtstar_planner::PlannerConfig;
+using nav2_rrtstar_planner::PlannerCore;
+using nav2_rrtstar_planner::TestGridMap;
+
+namespace {
+
+using Route = std::vector<std::pair<double, double>>;
+
+// Two offset walls, so the route has to weave between them
+void buildGoldenMap(TestGridMap& map) {
+    map.fill(6.0, 0.0, 7.0, 14.0);
+    map.fill(13.0, 6.0, 14.0, 20.0);
+    map.fill(2.0, 16.0, 4.0, 18.0);
+}
+
+PlannerConfig goldenConfig(bool bidirectional, bool lazy, int num_threads) {
+    PlannerConfig config;
+    config.max_iterations = 2000;
+    config.deterministic = true;
+    config.seed = 42;
+    config.bidirectional = bidirectional;
+    config.lazy_collision_checking = lazy;
+    config.num_threads = num_threads;
+    return config;
+}
+
+Route planGolden(PlannerCore& core) {
+    TestGridMap map;
+    buildGoldenMap(map);
+    Route route;
+    core.plan(map, 1.0, 1.0, 19.0, 19.0, route);
+    return route;
+}
+
+// Plans the golden query in one mode with every thread count and checks every route is
+// bit-identical to the single-threaded one, also when the same core plans it again
+void expectIdenticalRoutes(bool bidirectional, bool lazy) {
+    PlannerCore reference_core;
+    reference_core.configure(goldenConfig(bidirectional, lazy, 1));
+    const Route reference = planGolden(reference_core);
+    ASSERT_GE(reference.size(), 3u);
+    EXPECT_EQ(reference.front(), std::make_pair(1.0, 1.0));
+    EXPECT_EQ(reference.back(), std::make_pair(19.0, 19.0));
+    EXPECT_EQ(planGolden(reference_core), reference) << "second plan on the same core";
+
+    for (int num_threads : {1, 2, 4, 8}) {
+        PlannerCore core;
+        core.configure(goldenConfig(bidirectional, lazy, num_threads));
+        for (int run = 0; run < 2; ++run) {
+            EXPECT_EQ(planGolden(core), reference) << num_threads << " threads, run " << run;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(Determinism, SingleTreeRouteIsBitIdentical) {
+    expectIdenticalRoutes(false, false);
+}
+
+TEST(Determinism, BidirectionalRouteIsBitIdentical) {
+    expectIdenticalRoutes(true, false);
+}
+
+TEST(Determinism, LazyRouteIsBitIdentical) {
+    expectIdenticalRoutes(false, true);
+}
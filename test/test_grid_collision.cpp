@@ -0,0 +1,180 @@
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nav2_rrtstar_planner/grid_collision.hpp"
+
+using nav2_rrtstar_planner::GridView;
+using nav2_rrtstar_planner::segmentFree;
+
+namespace {
+
+// Occupancy grid owning its cells
+struct TestGrid {
+    TestGrid(unsigned int size_x, unsigned int size_y, double origin_x, double origin_y, double resolution)
+    : cells(size_x * size_y, 0), view{nullptr, size_x, size_y, origin_x, origin_y, resolution} {
+        view.data = cells.data();
+    }
+    void block(unsigned int x, unsigned int y) { cells[y * view.size_x + x] = 254; }
+
+    std::vector<unsigned char> cells;
+    GridView view;
+};
+
+// The checker the traversal replaced: samples the segment every step meters and tests the cell
+// under each sample
+bool steppedFree(const GridView& grid, double x0, double y0, double x1, double y1, double step) {
+    const int steps = std::max(static_cast<int>(std::ceil(std::hypot(x1 - x0, y1 - y0) / step)), 1);
+    for (int i = 0; i <= steps; ++i) {
+        double t = static_cast<double>(i) / steps;
+        double cx = std::floor((x0 + t * (x1 - x0) - grid.origin_x) / grid.resolution);
+        double cy = std::floor((y0 + t * (y1 - y0) - grid.origin_y) / grid.resolution);
+        if (cx < 0 || cy < 0 || cx >= grid.size_x || cy >= grid.size_y) return false;
+        if (grid.data[static_cast<std::size_t>(cy) * grid.size_x + static_cast<std::size_t>(cx)] != 0) return false;
+    }
+    return true;
+}
+
+// Longest piece of the segment inside any blocked cell, from Liang-Barsky clipping against each
+double longestBlockedOverlap(const TestGrid& grid, double x0, double y0, double x1, double y1) {
+    const GridView& view = grid.view;
+    double longest = 0.0;
+    for (unsigned int cy = 0; cy < view.size_y; ++cy) {
+        for (unsigned int cx = 0; cx < view.size_x; ++cx) {
+            if (grid.cells[cy * view.size_x + cx] == 0) continue;
+            double t_min = 0.0, t_max = 1.0;
+            const double lo[2] = {view.origin_x + cx * view.resolution, view.origin_y + cy * view.resolution};
+            const double start[2] = {x0, y0}, delta[2] = {x1 - x0, y1 - y0};
+            for (int axis = 0; axis < 2; ++axis) {
+                double hi = lo[axis] + view.resolution;
+                if (delta[axis] == 0.0) {
+                    if (start[axis] < lo[axis] || start[axis] > hi) t_max = -1.0;
+                    continue;
+                }
+                double t0 = (lo[axis] - start[axis]) / delta[axis], t1 = (hi - start[axis]) / delta[axis];
+                t_min = std::max(t_min, std::min(t0, t1));
+                t_max = std::min(t_max, std::max(t0, t1));
+            }
+            if (t_max >= t_min) longest = std::max(longest, (t_max - t_min) * std::hypot(delta[0], delta[1]));
+        }
+    }
+    return longest;
+}
+
+}  // namespace
+
+TEST(SegmentFree, MatchesFixedStepChecker) {
+    std::mt19937 gen(4);
+    TestGrid grid(40, 30, -1.0, 2.0, 0.05);
+    std::bernoulli_distribution blocked(0.05);
+    for (unsigned int y = 0; y < 30; ++y) {
+        for (unsigned int x = 0; x < 40; ++x) {
+            if (blocked(gen)) grid.block(x, y);
+        }
+    }
+
+    // Endpoints stay on the map, so a disagreement can only come from a blocked cell. The
+    // traversal never misses a cell the samples hit; it may only catch a corner the segment
+    // clips for less than one sample step, which the samples jump over.
+    const double step = 0.0002;
+    std::uniform_real_distribution<> px(-0.999, 0.999), py(2.001, 3.499);
+    int blocked_segments = 0, corner_clips = 0;
+    for (int i = 0; i < 20000; ++i) {
+        double x0 = px(gen), y0 = py(gen), x1 = px(gen), y1 = py(gen);
+        bool free = segmentFree(grid.view, x0, y0, x1, y1);
+        bool stepped_free = steppedFree(grid.view, x0, y0, x1, y1, step);
+        blocked_segments += !free;
+        if (free == stepped_free) continue;
+        corner_clips++;
+        EXPECT_FALSE(free) << "(" << x0 << ", " << y0 << ") -> (" << x1 << ", " << y1 << ")";
+        EXPECT_LT(longestBlockedOverlap(grid, x0, y0, x1, y1), step)
+            << "(" << x0 << ", " << y0 << ") -> (" << x1 << ", " << y1 << ")";
+    }
+    EXPECT_LT(corner_clips, 20);
+    // Both outcomes are well represented
+    EXPECT_GT(blocked_segments, 2000);
+    EXPECT_LT(blocked_segments, 18000);
+}
+
+TEST(SegmentFree, VisitsEachCrossedCellOnce) {
+    std::mt19937 gen(5);
+    TestGrid grid(40, 30, -1.0, 2.0, 0.05);
+    std::uniform_real_distribution<> px(-1.0, 1.0), py(2.0, 3.5);
+    for (int i = 0; i < 2000; ++i) {
+        double x0 = px(gen), y0 = py(gen), x1 = px(gen), y1 = py(gen);
+        std::size_t cells = 0;
+        ASSERT_TRUE(segmentFree(grid.view, x0, y0, x1, y1, cells));
+        // One cell per crossed boundary plus the first one
+        long crossed = std::labs(static_cast<long>(std::floor((x1 + 1.0) / 0.05)) -
+                                 static_cast<long>(std::floor((x0 + 1.0) / 0.05))) +
+                       std::labs(static_cast<long>(std::floor((y1 - 2.0) / 0.05)) -
+                                 static_cast<long>(std::floor((y0 - 2.0) / 0.05)));
+        EXPECT_EQ(cells, static_cast<std::size_t>(crossed + 1));
+    }
+}
+
+TEST(SegmentFree, LeavingTheMapIsBlocked) {
+    TestGrid grid(40, 30, -1.0, 2.0, 0.05);
+    EXPECT_FALSE(segmentFree(grid.view, 0.0, 3.0, 1.1, 3.0));
+    EXPECT_FALSE(segmentFree(grid.view, 0.0, 3.0, 0.0, 1.9));
+    EXPECT_FALSE(steppedFree(grid.view, 0.0, 3.0, 1.1, 3.0, 0.0002));
+}
+
+TEST(SegmentFree, SegmentsAlongCellBoundaries) {
+    // A power-of-two resolution keeps the boundaries exact in floating point. A point on a
+    // boundary belongs to the cell above / to the right of it, as with the fixed-step checker.
+    TestGrid grid(8, 8, -2.0, 0.0, 0.25);
+    grid.block(3, 4);
+    // Along the line y = 1.0 between rows 3 and 4, crossing column 3 (x in [-1.25, -1.0))
+    EXPECT_FALSE(segmentFree(grid.view, -1.9, 1.0, -0.1, 1.0));
+    EXPECT_FALSE(segmentFree(grid.view, -0.1, 1.0, -1.9, 1.0));
+    // Along y = 0.75, the row below the blocked cell
+    EXPECT_TRUE(segmentFree(grid.view, -1.9, 0.75, -0.1, 0.75));
+    EXPECT_TRUE(segmentFree(grid.view, -0.1, 0.75, -1.9, 0.75));
+    // Along x = -1.0, the boundary to the right of column 3
+    EXPECT_TRUE(segmentFree(grid.view, -1.0, 0.1, -1.0, 1.9));
+    // Along x = -1.25, the left boundary of column 3
+    EXPECT_FALSE(segmentFree(grid.view, -1.25, 0.1, -1.25, 1.9));
+    EXPECT_FALSE(segmentFree(grid.view, -1.25, 1.9, -1.25, 0.1));
+    for (double y : {0.75, 1.0}) {
+        for (double x : {-1.25, -1.0}) {
+            EXPECT_EQ(segmentFree(grid.view, x, 0.1, x, 1.9), steppedFree(grid.view, x, 0.1, x, 1.9, 0.001));
+        }
+        EXPECT_EQ(segmentFree(grid.view, -1.9, y, -0.1, y), steppedFree(grid.view, -1.9, y, -0.1, y, 0.001));
+    }
+}
+
+TEST(SegmentFree, DiagonalsThroughCellCorners) {
+    TestGrid grid(8, 8, 0.0, 0.0, 0.25);
+    // Cell centers on the main diagonal: the segment passes exactly through the shared corners
+    grid.block(3, 3);
+    EXPECT_FALSE(segmentFree(grid.view, 0.125, 0.125, 1.875, 1.875));
+    EXPECT_FALSE(segmentFree(grid.view, 1.875, 1.875, 0.125, 0.125));
+    // Starting and ending exactly on a corner of the blocked cell
+    EXPECT_FALSE(segmentFree(grid.view, 0.75, 0.75, 0.25, 0.25));
+    EXPECT_FALSE(segmentFree(grid.view, 0.25, 0.25, 0.75, 0.75));
+    // Ending on its corner from below left touches only the cell above right of the corner
+    EXPECT_TRUE(segmentFree(grid.view, 0.125, 0.125, 0.5, 0.5));
+
+    // Whatever the fixed-step checker hits on a corner-crossing diagonal, the traversal hits too
+    for (unsigned int x = 0; x < 8; ++x) {
+        TestGrid single(8, 8, 0.0, 0.0, 0.25);
+        single.block(x, x);
+        EXPECT_FALSE(segmentFree(single.view, 0.125, 0.125, 1.875, 1.875)) << "cell " << x;
+        EXPECT_FALSE(steppedFree(single.view, 0.125, 0.125, 1.875, 1.875, 0.001)) << "cell " << x;
+    }
+    // The anti-diagonal through the corner of the blocked cell
+    if (!steppedFree(grid.view, 0.125, 1.875, 1.875, 0.125, 0.001)) {
+        EXPECT_FALSE(segmentFree(grid.view, 0.125, 1.875, 1.875, 0.125));
+    }
+}
+
+TEST(SegmentFree, OffMapAndPointSegments) {
+    TestGrid grid(4, 4, 0.0, 0.0, 1.0);
+    grid.block(2, 2);
+    EXPECT_TRUE(segmentFree(grid.view, 0.5, 0.5, 0.5, 0.5));
+    EXPECT_FALSE(segmentFree(grid.view, 2.5, 2.5, 2.5, 2.5));
+    EXPECT_FALSE(segmentFree(grid.view, -0.5, 0.5, 1.5, 0.5));
+    EXPECT_FALSE(segmentFree(grid.view, 0.5, 0.5, 0.5, 4.0));
+}
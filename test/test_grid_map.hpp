@@ -0,0 +1,46 @@
+#ifndef NAV2_RRTSTAR_PLANNER__TEST_GRID_MAP_HPP_
+#define NAV2_RRTSTAR_PLANNER__TEST_GRID_MAP_HPP_
+
+#include <algorithm>
+#include <vector>
+#include "nav2_rrtstar_planner/grid_map.hpp"
+
+namespace nav2_rrtstar_planner {
+
+// In-memory map for the planner tests: a free square of size_m meters at the origin
+class TestGridMap : public GridMap {
+public:
+    explicit TestGridMap(double size_m = 20.0, double resolution = 0.05)
+    : cells_x_(static_cast<unsigned int>(size_m / resolution)), resolution_(resolution),
+      cells_(cells_x_ * cells_x_, 0) {}
+
+    void lock() override { locks_++; }
+    void unlock() override { unlocks_++; }
+    GridView view() const override {
+        return GridView{cells_.data(), cells_x_, cells_x_, 0.0, 0.0, resolution_};
+    }
+
+    // Sets the cells of the box [x0, x1) x [y0, y1), in meters, to cost
+    void fill(double x0, double y0, double x1, double y1, unsigned char cost = 254) {
+        unsigned int cx0 = std::min(cell(x0), cells_x_), cx1 = std::min(cell(x1), cells_x_);
+        unsigned int cy0 = std::min(cell(y0), cells_x_), cy1 = std::min(cell(y1), cells_x_);
+        for (unsigned int y = cy0; y < cy1; ++y) {
+            std::fill(cells_.begin() + y * cells_x_ + cx0, cells_.begin() + y * cells_x_ + cx1, cost);
+        }
+    }
+
+    int locks_ = 0, unlocks_ = 0;
+
+private:
+    unsigned int cell(double meters) const {
+        return static_cast<unsigned int>(std::max(meters, 0.0) / resolution_ + 0.5);
+    }
+
+    unsigned int cells_x_;
+    double resolution_;
+    std::vector<unsigned char> cells_;
+};
+
+}  // namespace nav2_rrtstar_planner
+
+#endif  // NAV2_RRTSTAR_PLANNER__TEST_GRID_MAP_HPP_
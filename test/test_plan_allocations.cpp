@@ -0,0 +1,71 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nav2_rrtstar_planner/planner_core.hpp"
+#include "test_grid_map.hpp"
+
+// Every allocation of the test binary goes through here; the tests read the count around the
+// calls they measure
+namespace {
+std::atomic<std::size_t> allocations{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+using nav2_rrtstar_planner::PlannerConfig;
+using nav2_rrtstar_planner::PlannerCore;
+using nav2_rrtstar_planner::TestGridMap;
+
+namespace {
+
+// Replans the same query; returns the allocations made by the last plan
+std::size_t allocationsOfReplan(const PlannerConfig& config, TestGridMap& map, int plans) {
+    PlannerCore core;
+    core.configure(config);
+    std::vector<std::pair<double, double>> route;
+    std::size_t before = 0;
+    for (int i = 0; i < plans; ++i) {
+        before = allocations.load();
+        core.plan(map, 1.0, 1.0, 19.0, 19.0, route);
+    }
+    return allocations.load() - before;
+}
+
+}  // namespace
+
+// Once the first plan has sized the tree, the indexes and the scratch buffers, replanning on the
+// same map reuses their capacity
+TEST(PlanAllocations, SteadyStateReplanDoesNotAllocate) {
+    TestGridMap map;
+    map.fill(9.0, 0.0, 10.0, 15.0);
+    PlannerConfig config;
+    config.deterministic = true;
+    config.seed = 11;
+    EXPECT_EQ(allocationsOfReplan(config, map, 2), 0u);
+
+    config.bidirectional = true;
+    EXPECT_EQ(allocationsOfReplan(config, map, 2), 0u);
+
+    config.bidirectional = false;
+    config.lazy_collision_checking = true;
+    EXPECT_EQ(allocationsOfReplan(config, map, 2), 0u);
+
+    config.lazy_collision_checking = false;
+    config.num_threads = 4;
+    EXPECT_EQ(allocationsOfReplan(config, map, 2), 0u);
+}
@@ -0,0 +1,143 @@
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nav2_rrtstar_planner/planner_core.hpp"
+#include "test_grid_map.hpp"
+
+using nav2_rrtstar_planner::PlannerConfig;
+using nav2_rrtstar_planner::PlannerCore;
+using nav2_rrtstar_planner::PlanningError;
+using nav2_rrtstar_planner::TestGridMap;
+
+namespace {
+
+// Exposes the clamped settings
+class TestCore : public PlannerCore {
+public:
+    using PlannerCore::max_iterations_;
+    using PlannerCore::max_planning_time_;
+};
+
+}  // namespace
+
+TEST(PlannerCore, ClampsOutOfRangeBudgets) {
+    TestGridMap map;
+    std::vector<std::pair<double, double>> route;
+    for (int max_iterations : {0, -5}) {
+        TestCore core;
+        PlannerConfig config;
+        config.max_iterations = max_iterations;
+        config.max_planning_time = -1.0;
+        core.configure(config);
+        EXPECT_EQ(core.max_iterations_, 1);
+        EXPECT_EQ(core.max_planning_time_, 0.0);
+        // A one-vertex budget may not reach the goal, but may only fail with a PlanningError
+        try {
+            core.plan(map, 1.0, 1.0, 19.0, 19.0, route);
+        } catch (const PlanningError&) {
+        }
+    }
+}
+
+namespace {
+
+// Plans from the open side of the map to a goal enclosed by a 0.5 m thick wall; returns the
+// seconds until PlanningError was thrown, or a negative value if the plan succeeded
+double secondsToFailure(const PlannerConfig& config) {
+    TestGridMap map;
+    map.fill(14.0, 14.0, 20.0, 14.5);
+    map.fill(14.0, 14.0, 14.5, 20.0);
+    PlannerCore core;
+    core.configure(config);
+    std::vector<std::pair<double, double>> route;
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        core.plan(map, 1.0, 1.0, 18.0, 18.0, route);
+    } catch (const PlanningError&) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return -1.0;
+}
+
+}  // namespace
+
+TEST(PlannerCore, UnreachableGoalFailsWithinFixedIterations) {
+    PlannerConfig config;
+    double seconds = secondsToFailure(config);
+    EXPECT_GE(seconds, 0.0) << "planned through the wall";
+    EXPECT_LT(seconds, 2.0);
+
+    config.bidirectional = true;
+    seconds = secondsToFailure(config);
+    EXPECT_GE(seconds, 0.0) << "planned through the wall";
+    EXPECT_LT(seconds, 2.0);
+}
+
+TEST(PlannerCore, UnreachableGoalFailsWithinTheDeadline) {
+    PlannerConfig config;
+    config.max_planning_time = 0.2;
+    for (bool bidirectional : {false, true}) {
+        config.bidirectional = bidirectional;
+        double seconds = secondsToFailure(config);
+        EXPECT_GE(seconds, 0.0) << "planned through the wall";
+        // Growth checks the clock every few samples; the tolerance covers setup and a CI machine
+        EXPECT_GE(seconds, config.max_planning_time);
+        EXPECT_LT(seconds, config.max_planning_time + 0.3) << "bidirectional=" << bidirectional;
+    }
+}
+
+TEST(PlannerCore, GoalInsideAnObstacleFails) {
+    TestGridMap map;
+    map.fill(17.0, 17.0, 19.0, 19.0);
+    PlannerCore core;
+    PlannerConfig config;
+    config.max_planning_time = 0.1;
+    core.configure(config);
+    std::vector<std::pair<double, double>> route;
+    EXPECT_THROW(core.plan(map, 1.0, 1.0, 18.0, 18.0, route), PlanningError);
+}
+
+// The core plans on any GridMap and holds it only while copying the cells, also when it fails
+TEST(PlannerCore, LocksTheMapOncePerPlan) {
+    TestGridMap map;
+    map.fill(9.0, 0.0, 10.0, 15.0);
+    PlannerCore core;
+    PlannerConfig config;
+    config.deterministic = true;
+    core.configure(config);
+    std::vector<std::pair<double, double>> route;
+    core.plan(map, 1.0, 1.0, 19.0, 1.0, route);
+    EXPECT_EQ(map.locks_, 1);
+    EXPECT_EQ(map.unlocks_, 1);
+    ASSERT_GE(route.size(), 2u);
+    EXPECT_EQ(route.front(), std::make_pair(1.0, 1.0));
+    EXPECT_EQ(route.back(), std::make_pair(19.0, 1.0));
+
+    map.fill(18.0, 0.0, 20.0, 2.0);
+    EXPECT_THROW(core.plan(map, 1.0, 1.0, 19.0, 1.0, route), PlanningError);
+    EXPECT_EQ(map.locks_, 2);
+    EXPECT_EQ(map.unlocks_, 2);
+}
+
+// The rewire radius must keep RRT* asymptotically optimal: on an empty map more vertices bring
+// the route down to the straight line
+TEST(PlannerCore, CostConvergesWithIterations) {
+    TestGridMap map;
+    std::vector<std::pair<double, double>> route;
+    double previous_cost = std::numeric_limits<double>::infinity();
+    for (int max_iterations : {300, 3000}) {
+        PlannerCore core;
+        PlannerConfig config;
+        config.max_iterations = max_iterations;
+        config.deterministic = true;
+        config.seed = 3;
+        core.configure(config);
+        core.plan(map, 1.0, 1.0, 19.0, 19.0, route);
+        EXPECT_LT(core.statistics().solution_cost, previous_cost) << max_iterations << " iterations";
+        previous_cost = core.statistics().solution_cost;
+    }
+    EXPECT_LT(previous_cost, 1.005 * std::hypot(18.0, 18.0));
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nav2_rrtstar_planner/grid_index.hpp"
+#include "nav2_rrtstar_planner/kd_tree.hpp"
+#include "nav2_rrtstar_planner/nearest_kernel.hpp"
+
+using nav2_rrtstar_planner::GridIndex;
+using nav2_rrtstar_planner::KDTree;
+using nav2_rrtstar_planner::nearestBruteForce;
+
+namespace {
+
+struct Points {
+    std::vector<double> x, y;
+};
+
+// Uniform points, or points inserted in sorted order along a diagonal, which forces the
+// scapegoat rebuilds an incremental k-d tree needs to stay balanced
+Points makePoints(std::size_t count, bool sorted, std::mt19937& gen) {
+    std::uniform_real_distribution<> coord(0.0, 50.0);
+    Points points;
+    for (std::size_t i = 0; i < count; ++i) {
+        points.x.push_back(coord(gen));
+        points.y.push_back(coord(gen));
+    }
+    if (sorted) {
+        std::sort(points.x.begin(), points.x.end());
+        std::sort(points.y.begin(), points.y.end());
+    }
+    return points;
+}
+
+double distanceSquared(const Points& points, std::size_t i, double x, double y) {
+    return (points.x[i] - x) * (points.x[i] - x) + (points.y[i] - y) * (points.y[i] - y);
+}
+
+}  // namespace
+
+TEST(KDTree, NearestMatchesBruteForce) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<> query(-5.0, 55.0);
+    for (bool sorted : {false, true}) {
+        Points points = makePoints(5000, sorted, gen);
+        KDTree tree;
+        for (std::size_t i = 0; i < points.x.size(); ++i) {
+            tree.insert(points.x[i], points.y[i], static_cast<int>(i));
+
+            // Query while the tree grows, so every rebuilt shape gets checked
+            if (i % 97 != 0) continue;
+            for (int q = 0; q < 20; ++q) {
+                double x = query(gen), y = query(gen);
+                uint32_t expected = nearestBruteForce(points.x.data(), points.y.data(), i + 1, x, y);
+                int nearest = tree.nearest(x, y);
+                ASSERT_GE(nearest, 0);
+                // Ties may resolve to another index, but never to a farther point
+                EXPECT_EQ(distanceSquared(points, nearest, x, y), distanceSquared(points, expected, x, y))
+                    << "sorted=" << sorted << " size=" << i + 1;
+            }
+        }
+    }
+}
+
+TEST(KDTree, EmptyTreeHasNoNearest) {
+    KDTree tree;
+    EXPECT_EQ(tree.nearest(1.0, 2.0), -1);
+}
+
+TEST(NearestKernel, MatchesScalarScan) {
+    std::mt19937 gen(2);
+    Points points = makePoints(1001, false, gen);
+    std::uniform_real_distribution<> query(-5.0, 55.0);
+    for (std::size_t count : {0u, 1u, 3u, 4u, 5u, 17u, 1001u}) {
+        for (int q = 0; q < 50; ++q) {
+            double x = query(gen), y = query(gen);
+            uint32_t expected = UINT32_MAX;
+            double best = INFINITY;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (distanceSquared(points, i, x, y) < best) {
+                    best = distanceSquared(points, i, x, y);
+                    expected = static_cast<uint32_t>(i);
+                }
+            }
+            EXPECT_EQ(nearestBruteForce(points.x.data(), points.y.data(), count, x, y), expected)
+                << "count=" << count;
+        }
+    }
+}
+
+TEST(GridIndex, RadiusQueryMatchesBruteForce) {
+    std::mt19937 gen(3);
+    Points points = makePoints(5000, false, gen);
+    GridIndex index;
+    index.reset(0.0, 0.0, 50.0, 50.0, 2.0);
+
+    std::uniform_real_distribution<> center(-2.0, 52.0);
+    std::uniform_real_distribution<> radius(0.0, 5.0);
+    std::vector<int> result;
+    // Each round re-files the points inserted so far into finer cells and inserts more, so
+    // queries see filed and freshly inserted points, with radii wider than a cell
+    std::size_t inserted = 0;
+    for (double cell_size : {2.0, 0.7, 0.3}) {
+        if (cell_size != index.cellSize()) index.rebuild(cell_size);
+        for (std::size_t end = inserted + points.x.size() / 3; inserted < end; ++inserted) {
+            index.insert(points.x[inserted], points.y[inserted], static_cast<int>(inserted));
+        }
+        for (int q = 0; q < 300; ++q) {
+            double x = center(gen), y = center(gen), r = radius(gen);
+            result.clear();
+            index.query(x, y, r, result);
+            std::sort(result.begin(), result.end());
+
+            std::vector<int> expected;
+            for (std::size_t i = 0; i < inserted; ++i) {
+                if (distanceSquared(points, i, x, y) <= r * r) expected.push_back(static_cast<int>(i));
+            }
+            EXPECT_EQ(result, expected) << "cells " << cell_size << " center (" << x << ", " << y << ") radius " << r;
+        }
+    }
+}
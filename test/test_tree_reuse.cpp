@@ -0,0 +1,90 @@
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nav2_rrtstar_planner/planner_core.hpp"
+#include "test_grid_map.hpp"
+
+using nav2_rrtstar_planner::PlannerConfig;
+using nav2_rrtstar_planner::PlannerCore;
+using nav2_rrtstar_planner::TestGridMap;
+
+namespace {
+
+// A wall across the map with a gap at its far end, so every route to the goal detours
+void buildDetourMap(TestGridMap& map) {
+    map.fill(9.5, 0.0, 10.5, 16.0);
+}
+
+PlannerConfig reuseConfig() {
+    PlannerConfig config;
+    config.max_iterations = 1000;
+    config.reuse_tree = true;
+    config.deterministic = true;
+    config.seed = 5;
+    return config;
+}
+
+}  // namespace
+
+// Every warm start adds vertices on top of the kept ones; the kept tree must be capped so the
+// tree, and the cost of re-rooting it, stays bounded however often the robot replans
+TEST(TreeReuse, RepeatedReplansStayBounded) {
+    TestGridMap map;
+    buildDetourMap(map);
+    PlannerCore core;
+    PlannerConfig config = reuseConfig();
+    core.configure(config);
+    std::vector<std::pair<double, double>> route;
+    std::size_t reused_plans = 0;
+    for (int i = 0; i < 100; ++i) {
+        // The start wobbles as a robot holding its position would
+        double offset = (i % 2) * 0.1;
+        core.plan(map, 1.0 + offset, 1.0, 19.0, 2.0, route);
+        EXPECT_LE(core.statistics().vertices, static_cast<std::size_t>(config.max_iterations)) << "plan " << i;
+        reused_plans += core.statistics().reused_vertices > 0;
+    }
+    EXPECT_GE(reused_plans, 90u);
+}
+
+namespace {
+
+// Plans, changes the map, and replans from further along the way, where the previous cost prunes
+// the vertices left behind
+std::size_t reusedAfter(void (*change)(TestGridMap&, const std::vector<std::pair<double, double>>&)) {
+    TestGridMap map;
+    PlannerCore core;
+    core.configure(reuseConfig());
+    std::vector<std::pair<double, double>> route;
+    core.plan(map, 1.0, 1.0, 19.0, 2.0, route);
+    change(map, route);
+    core.plan(map, 10.0, 1.5, 19.0, 2.0, route);
+    return core.statistics().reused_vertices;
+}
+
+void noChange(TestGridMap&, const std::vector<std::pair<double, double>>&) {}
+
+}  // namespace
+
+// Costmap noise blocks a cell somewhere on almost every update. A cell away from the previous
+// route leaves its cost a valid bound, so the tree is pruned just as without the noise.
+TEST(TreeReuse, NoiseAwayFromTheRouteStillPrunes) {
+    std::size_t clean = reusedAfter(noChange);
+    std::size_t noisy = reusedAfter([](TestGridMap& map, const std::vector<std::pair<double, double>>&) {
+        map.fill(0.0, 19.9, 0.1, 20.0);
+    });
+    EXPECT_LT(clean, 800u);
+    EXPECT_LE(noisy, clean);
+    EXPECT_GE(noisy, clean * 9 / 10);
+}
+
+// A cell on the previous route widens the bound rather than lifting it
+TEST(TreeReuse, BlockedRouteStillPrunes) {
+    std::size_t clean = reusedAfter(noChange);
+    std::size_t blocked = reusedAfter([](TestGridMap& map, const std::vector<std::pair<double, double>>& route) {
+        const std::pair<double, double>& middle = route[route.size() / 2];
+        map.fill(middle.first - 0.1, middle.second - 0.1, middle.first + 0.1, middle.second + 0.1);
+    });
+    EXPECT_GT(blocked, 0u);
+    EXPECT_LT(blocked, 800u);
+    EXPECT_LE(blocked, clean + clean / 2);
+}